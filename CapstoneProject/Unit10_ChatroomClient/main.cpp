@@ -1,21 +1,170 @@
 // Standard headers and ncurses for terminal UI
 #include <ncurses.h>
 #include <vector>
+#include <deque>
 #include <string>
 #include <iostream>
+#include <functional>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+
+// --- Model Layer ---
+// Observable is the base for all UI models. Components subscribe a
+// callback and the model calls notify() whenever its data changes.
+// Callbacks may run on any thread (the synthetic feed pushes from a
+// worker thread), so subscribers should only flag themselves dirty.
+class Observable {
+private:
+    std::vector<std::function<void()>> subscribers;
+
+protected:
+    void notify() {
+        for (auto& callback : subscribers) callback();
+    }
+
+public:
+    virtual ~Observable() = default;
+
+    // Subscriptions are registered during setup, before any updates.
+    void subscribe(std::function<void()> callback) {
+        subscribers.push_back(callback);
+    }
+};
+
+// Room names plus the currently highlighted index.
+class RoomListModel : public Observable {
+private:
+    std::vector<std::string> rooms;
+    int selectedIndex = 0;
+    mutable std::mutex mtx;
+
+public:
+    void setRooms(const std::vector<std::string>& newRooms) {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            rooms = newRooms;
+            if (selectedIndex >= static_cast<int>(rooms.size()))
+                selectedIndex = std::max(0, static_cast<int>(rooms.size()) - 1);
+        }
+        notify();
+    }
+
+    // Move the selection up/down; keeps index inside bounds and only
+    // notifies when the selection actually changed.
+    void moveSelection(int direction) {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            int next = selectedIndex + direction;
+            if (next < 0) next = 0;
+            if (next >= static_cast<int>(rooms.size())) next = static_cast<int>(rooms.size()) - 1;
+            if (next == selectedIndex || next < 0) return;
+            selectedIndex = next;
+        }
+        notify();
+    }
+
+    std::vector<std::string> getRooms() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return rooms;
+    }
+
+    int getSelectedIndex() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return selectedIndex;
+    }
+
+    std::string getSelectedRoom() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return rooms.empty() ? "" : rooms[selectedIndex];
+    }
+};
+
+// Chat history. Only the newest maxHistory messages are kept so a
+// long-running feed does not grow memory without bound.
+class MessageStore : public Observable {
+private:
+    std::deque<std::string> messages;
+    size_t maxHistory;
+    unsigned long long totalAdded = 0;
+    mutable std::mutex mtx;
+
+public:
+    explicit MessageStore(size_t history = 5000) : maxHistory(history) {}
+
+    void add(const std::string& message) {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            messages.push_back(message);
+            if (messages.size() > maxHistory) messages.pop_front();
+            totalAdded++;
+        }
+        notify();
+    }
+
+    // Copy out only the newest `count` messages (what fits on screen).
+    std::vector<std::string> tail(size_t count) const {
+        std::lock_guard<std::mutex> lock(mtx);
+        size_t start = messages.size() > count ? messages.size() - count : 0;
+        return std::vector<std::string>(messages.begin() + start, messages.end());
+    }
+
+    unsigned long long getTotalAdded() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return totalAdded;
+    }
+};
+
+// Text currently being composed in the input box.
+class InputState : public Observable {
+private:
+    std::string text;
+
+public:
+    void addChar(char ch) {
+        text.push_back(ch);
+        notify();
+    }
+
+    void backspace() {
+        if (text.empty()) return;
+        text.pop_back();
+        notify();
+    }
+
+    // Return the composed text and clear the box.
+    std::string take() {
+        std::string result = text;
+        text.clear();
+        notify();
+        return result;
+    }
+
+    const std::string& getText() const { return text; }
+};
 
 // --- Abstract Base / Helper Class ---
 // UIComponent is a small wrapper around an ncurses WINDOW with
 // height/width/position stored so derived classes can implement
-// custom draw behavior. It also manages the window lifetime.
+// custom draw behavior. It also manages the window lifetime and a
+// dirty flag that bound models set when the component must re-render.
 class UIComponent {
 protected:
     WINDOW* window;
     int height, width, startY, startX;
+    std::atomic<bool> dirty;
+
+    // Subscribe to a model so any change marks this component dirty.
+    void bind(Observable& model) {
+        model.subscribe([this]() { dirty = true; });
+    }
 
 public:
 // Constructor
-    UIComponent(int h, int w, int y, int x) : height(h), width(w), startY(y), startX(x) {
+    UIComponent(int h, int w, int y, int x) : height(h), width(w), startY(y), startX(x), dirty(true) {
         window = newwin(h, w, y, x);
     }
 
@@ -29,50 +178,56 @@ public:
     // the component contents into the WINDOW.
     virtual void draw() = 0;
 
-    // Helper to refresh the underlying ncurses window.
+    // Redraw only if a bound model changed since the last render.
+    // Returns true when a render happened.
+    bool renderIfDirty() {
+        if (!dirty.exchange(false)) return false;
+        draw();
+        return true;
+    }
+
+    // Stage the window for the next doupdate(); the controller flushes
+    // all changed windows to the terminal at once.
     void refreshWin() {
-        wrefresh(window);
+        wnoutrefresh(window);
     }
 };
 
 // --- Component: Header ---
-// Small header bar at the top of the screen that displays a title.
+// Small header bar at the top of the screen that displays a title and
+// the currently selected room.
 class HeaderArea : public UIComponent {
+private:
+    RoomListModel& roomModel;
+
 public:
     // Fixed height of 3 rows for the header
-    HeaderArea(int w) : UIComponent(3, w, 0, 0) {}
+    HeaderArea(int w, RoomListModel& rooms) : UIComponent(3, w, 0, 0), roomModel(rooms) {
+        bind(roomModel);
+    }
 
     // Draw the header: border + title using a colored attribute
     void draw() override {
         werase(window);
         box(window, 0, 0);
         wattron(window, COLOR_PAIR(1) | A_BOLD); // Use Color Pair 1
-        mvwprintw(window, 1, 2, "ADVANCED C++ CHAT CLIENT - Unit 10 Capstone");
+        mvwprintw(window, 1, 2, "ADVANCED C++ CHAT CLIENT - Unit 10 Capstone - #%s",
+                  roomModel.getSelectedRoom().c_str());
         wattroff(window, COLOR_PAIR(1) | A_BOLD);
         refreshWin();
     }
 };
 
 // --- Component: Room List ---
-// Left-side component that lists available rooms and manages a
-// selected index. Supports keyboard movement to change selection.
+// Left-side component that renders the RoomListModel, highlighting the
+// selected entry. Keyboard movement updates the model, not the view.
 class RoomList : public UIComponent {
 private:
-    std::vector<std::string> rooms; // list of room names
-    int selectedIndex;              // currently highlighted index
+    RoomListModel& model;
 
 public:
-    RoomList(int h, int y) : UIComponent(h, 20, y, 0), selectedIndex(0) {
-        // Sample/static rooms for demo purposes. In a real client
-        // these would be loaded from the server or a config.
-        rooms = {"General", "Sports", "Programming", "Off-Topic", "Announcements"};
-    }
-
-    // Move the selection up/down; keeps index inside bounds.
-    void moveSelection(int direction) {
-        selectedIndex += direction;
-        if (selectedIndex < 0) selectedIndex = 0;
-        if (selectedIndex >= static_cast<int>(rooms.size())) selectedIndex = rooms.size() - 1;
+    RoomList(int h, int y, RoomListModel& rooms) : UIComponent(h, 20, y, 0), model(rooms) {
+        bind(model);
     }
 
     // Render the room list, highlighting the selected entry.
@@ -81,7 +236,9 @@ public:
         box(window, 0, 0);
         mvwprintw(window, 0, 2, "[ Rooms ]");
 
-        for (size_t i = 0; i < rooms.size(); ++i) {
+        std::vector<std::string> rooms = model.getRooms();
+        int selectedIndex = model.getSelectedIndex();
+        for (size_t i = 0; i < rooms.size() && static_cast<int>(i) + 2 < height - 1; ++i) {
             if (static_cast<int>(i) == selectedIndex) {
                 wattron(window, A_REVERSE | COLOR_PAIR(2)); // Highlight selected
                 mvwprintw(window, i + 2, 2, " %-14s ", rooms[i].c_str());
@@ -93,27 +250,18 @@ public:
         }
         refreshWin();
     }
-    
-    // Return the currently selected room name.
-    std::string getSelectedRoom() const {
-        return rooms[selectedIndex];
-    }
 };
 
 // --- Component: Message Area ---
-// Main message display area (center-right). Shows a list of recent
-// messages. Currently uses a simple vector of strings as placeholder
-// data; in a real client this would be fed by the network layer.
+// Main message display area (center-right). Renders the newest messages
+// from the MessageStore; older history is never touched while drawing.
 class MessageArea : public UIComponent {
 private:
-    std::vector<std::string> messages; // stored messages to display
+    MessageStore& store;
 
 public:
-    MessageArea(int h, int w, int y, int x) : UIComponent(h, w, y, x) {
-        // Placeholder messages for demo purposes
-        messages.push_back("System: Welcome to the chat!");
-        messages.push_back("User1: Hello everyone.");
-        messages.push_back("User2: Working on the Unit 10 assignment?");
+    MessageArea(int h, int w, int y, int x, MessageStore& messages) : UIComponent(h, w, y, x), store(messages) {
+        bind(store);
     }
 
     // Draw messages top-to-bottom, clipping to the window height.
@@ -122,44 +270,107 @@ public:
         box(window, 0, 0);
         mvwprintw(window, 0, 2, "[ Messages ]");
 
+        std::vector<std::string> visible = store.tail(std::max(0, height - 2));
         int line = 1;
-        for (const auto& msg : messages) {
-            if (line < height - 1) {
-                mvwprintw(window, line, 2, "%s", msg.c_str());
-                line++;
-            }
+        for (const auto& msg : visible) {
+            mvwaddnstr(window, line++, 2, msg.c_str(), std::max(0, width - 4));
         }
         refreshWin();
     }
 };
 
 // --- Component: Input Area ---
-// Bottom input area for composing messages (currently static placeholder)
+// Bottom input area for composing messages, bound to InputState.
 class InputArea : public UIComponent {
+private:
+    InputState& input;
+
 public:
-    InputArea(int w, int y) : UIComponent(3, w, y, 0) {}
+    InputArea(int w, int y, InputState& state) : UIComponent(3, w, y, 0), input(state) {
+        bind(input);
+    }
 
-    // Draw a small compose box; actual input handling is not implemented
-    // in this demo and would require echoing and line-editing logic.
+    // Draw the compose box with the current text, or a hint when empty.
     void draw() override {
         werase(window);
         box(window, 0, 0);
         mvwprintw(window, 0, 2, "[ Compose ]");
-        mvwprintw(window, 1, 2, "> Type a message here... (Press Q to quit)");
+        if (input.getText().empty())
+            mvwprintw(window, 1, 2, "> Type a message here... (Q or F10 to quit)");
+        else
+            mvwprintw(window, 1, 2, "> %s", input.getText().c_str());
         refreshWin();
     }
 };
 
+// --- Synthetic Feed ---
+// Pushes generated messages into the MessageStore at a fixed rate from
+// a worker thread, used to benchmark render cost per model update.
+class SyntheticFeed {
+private:
+    MessageStore& store;
+    int ratePerSecond;
+    std::atomic<bool> running;
+    std::thread worker;
+
+    void run() {
+        using Clock = std::chrono::steady_clock;
+        const char* users[] = {"alice", "bob", "carol", "dave"};
+        auto start = Clock::now();
+        unsigned long long sent = 0;
+
+        while (running) {
+            // Catch up to the number of messages due by now, then sleep a tick.
+            double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+            unsigned long long due = static_cast<unsigned long long>(elapsed * ratePerSecond);
+            for (; sent < due && running; ++sent) {
+                store.add(std::string(users[sent % 4]) + ": synthetic message #" + std::to_string(sent));
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+public:
+    SyntheticFeed(MessageStore& messages, int rate) : store(messages), ratePerSecond(rate), running(false) {}
+
+    ~SyntheticFeed() { stop(); }
+
+    void start() {
+        running = true;
+        worker = std::thread(&SyntheticFeed::run, this);
+    }
+
+    void stop() {
+        running = false;
+        if (worker.joinable()) worker.join();
+    }
+};
+
+// --- Render Statistics ---
+// Per-component render counts and time spent in draw(), reported after
+// a feed run.
+struct RenderStats {
+    unsigned long long frames = 0;
+    unsigned long long headerRenders = 0, roomRenders = 0, messageRenders = 0, inputRenders = 0;
+    double messageRenderMs = 0;
+    double flushMs = 0;
+};
+
 // --- Main Application Controller ---
-// Top-level UI controller that wires the components together and
-// drives the main input/render loop.
+// Top-level UI controller that owns the models, wires the components to
+// them and drives the main input/render loop.
 class ChatClientUI {
 private:
+    RoomListModel roomModel;
+    MessageStore messageStore;
+    InputState inputState;
+
     HeaderArea* header;
     RoomList* roomList;
     MessageArea* messageArea;
     InputArea* inputArea;
     bool isRunning;
+    RenderStats stats;
 
     // Initialize ncurses settings and color pairs used by the UI.
     void initCurses() {
@@ -168,17 +379,79 @@ private:
         noecho();             // Don't echo while we do getch
         keypad(stdscr, TRUE); // Enable F-keys and arrows
         start_color();        // Enable colors
+        timeout(16);          // getch() waits at most one ~60 Hz frame
 
         // Define Color Pairs (Foreground, Background)
         init_pair(1, COLOR_CYAN, COLOR_BLACK);   // Header text
         init_pair(2, COLOR_GREEN, COLOR_BLACK);  // Selected room
-        
+
         refresh(); // Refresh main stdscr
     }
 
+    // Render only the components whose models changed, then flush all
+    // staged windows to the terminal in a single doupdate().
+    void renderFrame() {
+        using Clock = std::chrono::steady_clock;
+        bool any = false;
+
+        if (header->renderIfDirty()) { stats.headerRenders++; any = true; }
+        if (roomList->renderIfDirty()) { stats.roomRenders++; any = true; }
+
+        auto t0 = Clock::now();
+        if (messageArea->renderIfDirty()) {
+            stats.messageRenders++;
+            stats.messageRenderMs += std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+            any = true;
+        }
+
+        if (inputArea->renderIfDirty()) { stats.inputRenders++; any = true; }
+
+        if (any) {
+            auto t1 = Clock::now();
+            doupdate();
+            stats.flushMs += std::chrono::duration<double, std::milli>(Clock::now() - t1).count();
+        }
+        stats.frames++;
+    }
+
+    // Handle one key press by updating the models.
+    void handleKey(int ch) {
+        switch (ch) {
+            case ERR:
+                break;
+            case KEY_UP:
+                roomModel.moveSelection(-1);
+                break;
+            case KEY_DOWN:
+                roomModel.moveSelection(1);
+                break;
+            case KEY_F(10):
+                isRunning = false;
+                break;
+            case KEY_BACKSPACE:
+            case 127:
+                inputState.backspace();
+                break;
+            case '\n':
+            case KEY_ENTER: {
+                std::string text = inputState.take();
+                if (!text.empty()) messageStore.add("You: " + text);
+                break;
+            }
+            default:
+                // Q quits only while nothing is being typed
+                if ((ch == 'q' || ch == 'Q') && inputState.getText().empty()) {
+                    isRunning = false;
+                } else if (ch >= 32 && ch <= 126) {
+                    inputState.addChar(static_cast<char>(ch));
+                }
+                break;
+        }
+    }
+
 public:
     // Construct the UI, establish layout using the terminal size,
-    // and create the component objects.
+    // create the component objects and bind them to the models.
     ChatClientUI() : isRunning(true) {
         initCurses();
 
@@ -191,10 +464,14 @@ public:
         int mainContentH = maxH - headerH - inputH;
 
         // Initialize Components
-        header = new HeaderArea(maxW);
-        roomList = new RoomList(mainContentH, headerH);
-        messageArea = new MessageArea(mainContentH, maxW - 20, headerH, 20);
-        inputArea = new InputArea(maxW, maxH - inputH);
+        header = new HeaderArea(maxW, roomModel);
+        roomList = new RoomList(mainContentH, headerH, roomModel);
+        messageArea = new MessageArea(mainContentH, maxW - 20, headerH, 20, messageStore);
+        inputArea = new InputArea(maxW, maxH - inputH, inputState);
+
+        // Initial data goes through the models like any later update.
+        roomModel.setRooms({"General", "Sports", "Programming", "Off-Topic", "Announcements"});
+        messageStore.add("System: Welcome to the chat!");
     }
 
     // Clean up and end curses mode. Deleting components will free
@@ -207,38 +484,62 @@ public:
         endwin(); // End curses mode
     }
 
-    // Main loop: draw UI and handle a small set of inputs for demo.
-    void run() {
+    MessageStore& getMessageStore() { return messageStore; }
+    const RenderStats& getStats() const { return stats; }
+
+    // Main loop: render changed components and apply input to the models.
+    // A positive duration ends the loop after that many seconds.
+    void run(double seconds = 0) {
+        auto start = std::chrono::steady_clock::now();
         while (isRunning) {
-            // Draw all components
-            header->draw();
-            roomList->draw();
-            messageArea->draw();
-            inputArea->draw();
-
-            // Handle Input: arrow keys change room selection; Q quits.
-            int ch = getch();
-            switch (ch) {
-                case KEY_UP:
-                    roomList->moveSelection(-1);
-                    break;
-                case KEY_DOWN:
-                    roomList->moveSelection(1);
-                    break;
-                case 'q':
-                case 'Q':
-                    isRunning = false;
-                    break;
-                default:
-                    break;
-            }
+            renderFrame();
+            handleKey(getch());
+
+            if (seconds > 0 &&
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() >= seconds)
+                isRunning = false;
         }
     }
 };
 
 // --- Entry Point ---
-int main() {
-    ChatClientUI app;
-    app.run();
+// Usage: ./chatclient                      interactive demo
+//        ./chatclient --feed [rate] [sec]  synthetic feed benchmark
+//                                          (default 10000 msg/s for 5 s)
+int main(int argc, char* argv[]) {
+    bool feedMode = argc >= 2 && std::string(argv[1]) == "--feed";
+    int rate = (feedMode && argc >= 3) ? std::atoi(argv[2]) : 10000;
+    double seconds = (feedMode && argc >= 4) ? std::atof(argv[3]) : 5.0;
+
+    RenderStats stats;
+    unsigned long long updates = 0;
+    {
+        ChatClientUI app;
+        if (!feedMode) {
+            app.run();
+            return 0;
+        }
+
+        SyntheticFeed feed(app.getMessageStore(), rate);
+        feed.start();
+        app.run(seconds);
+        feed.stop();
+
+        stats = app.getStats();
+        updates = app.getMessageStore().getTotalAdded();
+    } // UI destroyed here so the report prints on the normal screen
+
+    std::cout << "--- Synthetic feed benchmark ---\n"
+              << "model updates:    " << updates << " (" << rate << " msg/s target)\n"
+              << "frames:           " << stats.frames << "\n"
+              << "renders:          messages " << stats.messageRenders
+              << ", rooms " << stats.roomRenders
+              << ", header " << stats.headerRenders
+              << ", input " << stats.inputRenders << "\n";
+    if (stats.messageRenders > 0 && updates > 0) {
+        std::cout << "message render:   " << stats.messageRenderMs * 1000.0 / stats.messageRenders
+                  << " us/render, " << stats.messageRenderMs * 1000.0 / updates << " us/update\n"
+                  << "terminal flush:   " << stats.flushMs * 1000.0 / stats.messageRenders << " us/frame\n";
+    }
     return 0;
-}
\ No newline at end of file
+}
@@ -8,27 +8,74 @@
 #include <iostream>
 #include <sstream>
 #include <chrono>
+#include <functional>
+#include <fstream>
+#include <deque>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
 #ifdef _WIN32
 #include <winsock2.h>
 #include <ws2tcpip.h>
 #pragma comment(lib, "Ws2_32.lib")
+#define SHUT_RDWR SD_BOTH
 #else
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <unistd.h>
+#include <cerrno>
+#include <csignal>
 #define closesocket close
 #endif
 using namespace std;
 
+// --- Send Options ---
+// noDelay disables Nagle's algorithm (TCP_NODELAY); corkMs holds the first queued
+// frame back for up to that many milliseconds so a burst (e.g. a paste) leaves as
+// one writev() batch. Both can be set from the command line (--nagle, --cork <ms>).
+struct SendOptions {
+    bool noDelay = true;
+    int corkMs = 0;
+};
+
+// Counters for comparing batching modes
+struct SendStats {
+    atomic<unsigned long long> frames{0};
+    atomic<unsigned long long> batches{0};
+    atomic<unsigned long long> bytes{0};
+};
+
 // --- Network Manager --- 
+// Outgoing lines are framed with '\n' and queued; a sender thread drains the queue
+// so several pending frames go out in a single writev() call.
 class NetworkManager {
 private:
     int sock;
     atomic<bool> running;
     thread receiveThread;
+    thread sendThread;
     vector<string>* messages;
     mutex* messagesMutex;
     string username;
+    function<void(const string&)> onReceive;
+    SendOptions options;
+    SendStats stats;
+
+    deque<string> outbox;
+    mutex outboxMutex;
+    condition_variable outboxReady;
+    bool stopSending;
+    bool senderDone; // sendLoop() has returned; guarded by outboxMutex
+
+    // How long disconnect() lets the sender flush before cutting the socket; a
+    // server that stops reading would otherwise block writev() forever
+    static constexpr int FLUSH_TIMEOUT_MS = 2000;
+
+    static const size_t MAX_BATCH_FRAMES = 64;
+    static const size_t MAX_BATCH_BYTES = 64 * 1024;
 
     void receiveMessages() {
         char buffer[4096];
@@ -36,23 +83,124 @@ private:
             memset(buffer, 0, sizeof(buffer));
             int bytes = recv(sock, buffer, sizeof(buffer), 0);
             if (bytes > 0) {
-                lock_guard<mutex> lock(*messagesMutex);
-                messages->push_back(string(buffer, bytes));
+                string chunk(buffer, bytes);
+                // Hook runs before the chunk is queued so timestamps are taken at arrival
+                if (onReceive) onReceive(chunk);
+                if (messages) {
+                    lock_guard<mutex> lock(*messagesMutex);
+                    messages->push_back(chunk);
+                }
             } else if (bytes == 0) {
-                lock_guard<mutex> lock(*messagesMutex);
-                messages->push_back("[SERVER] Disconnected.");
+                if (messages) {
+                    lock_guard<mutex> lock(*messagesMutex);
+                    messages->push_back("[SERVER] Disconnected.");
+                }
+                if (onReceive) onReceive("[SERVER] Disconnected.");
                 break;
+            } else {
+                // recv() blocks, so only back off on errors instead of after every message
+                this_thread::sleep_for(chrono::milliseconds(50));
             }
-            this_thread::sleep_for(chrono::milliseconds(50));
         }
     }
 
+    // Writes the whole batch, resuming after partial writes
+    bool writeBatch(vector<string>& batch) {
+#ifdef _WIN32
+        string joined;
+        for (const auto& f : batch) joined += f;
+        size_t sent = 0;
+        while (sent < joined.size()) {
+            int n = send(sock, joined.data() + sent, (int)(joined.size() - sent), 0);
+            if (n <= 0) return false;
+            sent += n;
+        }
+#else
+        vector<iovec> iov(batch.size());
+        for (size_t i = 0; i < batch.size(); i++) {
+            iov[i].iov_base = (void*)batch[i].data();
+            iov[i].iov_len = batch[i].size();
+        }
+        size_t first = 0;
+        while (first < iov.size()) {
+            ssize_t n = writev(sock, &iov[first], (int)(iov.size() - first));
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            // Skip fully written buffers and trim the partially written one
+            while (first < iov.size() && (size_t)n >= iov[first].iov_len) {
+                n -= iov[first].iov_len;
+                first++;
+            }
+            if (first < iov.size()) {
+                iov[first].iov_base = (char*)iov[first].iov_base + n;
+                iov[first].iov_len -= n;
+            }
+        }
+#endif
+        return true;
+    }
+
+    void sendLoop() {
+        vector<string> batch;
+        while (true) {
+            {
+                unique_lock<mutex> lock(outboxMutex);
+                outboxReady.wait(lock, [&] { return stopSending || !outbox.empty(); });
+                if (outbox.empty()) return; // stopped and fully drained
+
+                // Corking window: give a burst a moment to accumulate behind the first frame
+                if (options.corkMs > 0 && !stopSending) {
+                    outboxReady.wait_for(lock, chrono::milliseconds(options.corkMs),
+                                         [&] { return stopSending || outbox.size() >= MAX_BATCH_FRAMES; });
+                }
+
+                size_t batchBytes = 0;
+                while (!outbox.empty() && batch.size() < MAX_BATCH_FRAMES && batchBytes < MAX_BATCH_BYTES) {
+                    batchBytes += outbox.front().size();
+                    batch.push_back(move(outbox.front()));
+                    outbox.pop_front();
+                }
+            }
+
+            unsigned long long bytes = 0;
+            for (const auto& f : batch) bytes += f.size();
+            if (!writeBatch(batch)) {
+                lock_guard<mutex> lock(outboxMutex);
+                outbox.clear();
+                return;
+            }
+            stats.frames += batch.size();
+            stats.batches++;
+            stats.bytes += bytes;
+            batch.clear();
+        }
+    }
+
+    void applySocketOptions() {
+        int flag = options.noDelay ? 1 : 0;
+        setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (const char*)&flag, sizeof(flag));
+    }
+
 public:
-    NetworkManager(vector<string>* msg, mutex* mtx) : sock(-1), messages(msg), messagesMutex(mtx), running(true) {}
+    // msg may be null when only the receive callback is wanted; nothing is stored then
+    NetworkManager(vector<string>* msg, mutex* mtx, const SendOptions& opts = SendOptions())
+        : sock(-1), running(true), messages(msg), messagesMutex(mtx), options(opts), stopSending(false),
+          senderDone(false) {}
     ~NetworkManager() { disconnect(); }
 
+    // Optional callback invoked from the receive thread for every chunk read from the socket.
+    // Must be set before connectToServer().
+    void setReceiveCallback(function<void(const string&)> cb) { onReceive = cb; }
+
+    const SendStats& getSendStats() const { return stats; }
+    const SendOptions& getSendOptions() const { return options; }
+
     bool connectToServer(const char* ip = "127.0.0.1", int port = 5400, const string& user = "") {
         username = user;
+#ifndef _WIN32
+        // A write to a reset or shut-down socket should fail with EPIPE, not kill the client
+        signal(SIGPIPE, SIG_IGN);
+#endif
         sock = socket(AF_INET, SOCK_STREAM, 0);
         if (sock < 0) return false;
 
@@ -63,25 +211,51 @@ public:
 
         if (::connect(sock, (sockaddr*)&serverHint, sizeof(serverHint)) < 0) {
             closesocket(sock);
+            sock = -1;
             return false;
         }
+        applySocketOptions();
+
+        sendThread = thread([this] {
+            sendLoop();
+            lock_guard<mutex> lock(outboxMutex);
+            senderDone = true;
+            outboxReady.notify_all();
+        });
 
         // Send username
-        if (!username.empty()) {
-            string userMsg = ".USERNAME " + username;
-            send(sock, userMsg.c_str(), (int)userMsg.size(), 0);
-        }
+        if (!username.empty()) sendMessage(".USERNAME " + username);
 
         receiveThread = thread(&NetworkManager::receiveMessages, this);
         return true;
     }
 
+    // Queues one line; the server splits frames on '\n'
     void sendMessage(const string& message) {
-        if (sock >= 0) send(sock, message.c_str(), (int)message.size(), 0);
+        if (sock < 0) return;
+        {
+            lock_guard<mutex> lock(outboxMutex);
+            if (stopSending) return;
+            outbox.push_back(message + "\n");
+        }
+        outboxReady.notify_one();
     }
 
     void disconnect() {
         running = false;
+        // Let the sender flush whatever is still queued before the socket goes away,
+        // but only for so long: shutdown() below also fails a writev() stuck on a full
+        // send buffer
+        if (sendThread.joinable()) {
+            unique_lock<mutex> lock(outboxMutex);
+            stopSending = true;
+            outboxReady.notify_all();
+            outboxReady.wait_for(lock, chrono::milliseconds(FLUSH_TIMEOUT_MS), [&] { return senderDone; });
+        }
+
+        // shutdown() wakes the receive thread out of its blocking recv()
+        if (sock >= 0) shutdown(sock, SHUT_RDWR);
+        if (sendThread.joinable()) sendThread.join();
         if (sock >= 0) {
             closesocket(sock);
             sock = -1;
@@ -90,6 +264,245 @@ public:
     }
 };
 
+// --- Headless Client ---
+// Drives NetworkManager from a script or a recorded session without curses,
+// so the real network path can be exercised on machines without a TTY.
+// Script lines are sent as-is; ".SLEEP <ms>" pauses and '#' starts a comment.
+// Recorded sessions hold "<ms offset>\t<line>" entries and are replayed at a speed factor.
+struct ScriptEntry {
+    long long atMs;   // offset from start (replay) or -1 to send immediately (script)
+    long long sleepMs; // pause before sending (script only)
+    string text;
+};
+
+class HeadlessClient {
+private:
+    typedef chrono::steady_clock Clock;
+
+    struct PendingMessage {
+        string text;
+        Clock::time_point sentAt;
+    };
+
+    NetworkManager* network;
+    vector<ScriptEntry> entries;
+    double speed;
+    int timeoutMs;
+    SendOptions sendOptions;
+
+    // State shared with the receive thread
+    mutex stateMutex;
+    condition_variable stateChanged;
+    string username;
+    deque<PendingMessage> pending;
+    string received; // unfinished last line of the receive stream
+    vector<pair<string, double>> results; // message text, RTT in ms
+    Clock::time_point firstSendAt, lastEchoAt;
+    size_t serverReplies;
+    bool disconnected;
+    bool nameConfirmed;
+
+    static string extractBetween(const string& s, const string& open, const string& close) {
+        size_t pos = s.find(open);
+        if (pos == string::npos) return "";
+        pos += open.size();
+        size_t end = s.find_first_of(close, pos);
+        if (end == string::npos) end = s.size();
+        return s.substr(pos, end - pos);
+    }
+
+    void onReceive(const string& chunk) {
+        Clock::time_point now = Clock::now();
+        lock_guard<mutex> lock(stateMutex);
+
+        // Track the name the server knows us by; chat echoes are prefixed with it
+        string name = extractBetween(chunk, "Your username is: ", "\r\n");
+        if (!name.empty() && username.empty()) username = name;
+        name = extractBetween(chunk, "Username set to '", "'");
+        if (!name.empty()) username = name;
+        if (chunk.find("[SERVER] Username") != string::npos || chunk.find("[SERVER] Invalid username") != string::npos)
+            nameConfirmed = true;
+
+        if (chunk.find("[SERVER]") != string::npos) serverReplies++;
+        if (chunk.find("[SERVER] Disconnected.") == 0) disconnected = true;
+
+        // Broadcasts are '\n'-terminated, but a chunk may hold several or end partway
+        // through one; reassemble whole lines so an echo is only ever compared with a
+        // complete line (another user's "robot1: hi" must not match our "bot1: hi")
+        received += chunk;
+        size_t start = 0, newline;
+        while ((newline = received.find('\n', start)) != string::npos) {
+            string line = received.substr(start, newline - start);
+            start = newline + 1;
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (username.empty() || pending.empty()) continue;
+            const PendingMessage& p = pending.front();
+            if (line != username + ": " + p.text) continue;
+            results.push_back({p.text, chrono::duration<double, milli>(now - p.sentAt).count()});
+            pending.pop_front();
+            lastEchoAt = now;
+        }
+        received.erase(0, start);
+        // Only the unfinished last line is kept; cap it in case a peer never ends one
+        const size_t keep = 8192;
+        if (received.size() > keep) received.erase(0, received.size() - keep);
+        stateChanged.notify_all();
+    }
+
+    // Waits until the server has answered at least once more than `seen` times
+    bool waitForServerReply(size_t seen) {
+        unique_lock<mutex> lock(stateMutex);
+        return stateChanged.wait_for(lock, chrono::milliseconds(timeoutMs),
+                                     [&] { return serverReplies > seen || disconnected; });
+    }
+
+    void sendEntry(const string& text) {
+        if (text[0] == '.') {
+            // Commands get a server reply; waiting for it keeps the next send from
+            // being coalesced with the command on the server side
+            size_t seen;
+            {
+                lock_guard<mutex> lock(stateMutex);
+                seen = serverReplies;
+            }
+            network->sendMessage(text);
+            if (!waitForServerReply(seen))
+                cerr << "[HEADLESS] No reply to command: " << text << endl;
+            return;
+        }
+        lock_guard<mutex> lock(stateMutex);
+        Clock::time_point now = Clock::now();
+        if (results.empty() && pending.empty()) firstSendAt = now;
+        pending.push_back({text, now});
+        network->sendMessage(text);
+    }
+
+    void printReport() {
+        lock_guard<mutex> lock(stateMutex);
+        cout << "--- Round-trip times ---" << endl;
+        for (const auto& r : results) {
+            char line[64];
+            snprintf(line, sizeof(line), "%10.3f ms  ", r.second);
+            cout << line << r.first << endl;
+        }
+        for (const auto& p : pending)
+            cout << "      lost     " << p.text << endl;
+
+        cout << "--- Summary ---" << endl;
+        cout << "sent: " << results.size() + pending.size()
+             << "  echoed: " << results.size()
+             << "  lost: " << pending.size() << endl;
+
+        const SendStats& st = network->getSendStats();
+        cout << "mode: " << (sendOptions.noDelay ? "TCP_NODELAY" : "Nagle")
+             << ", cork " << sendOptions.corkMs << " ms"
+             << "  frames: " << st.frames << "  writev batches: " << st.batches
+             << "  bytes: " << st.bytes << endl;
+        if (results.empty()) return;
+
+        vector<double> rtts;
+        double total = 0;
+        for (const auto& r : results) {
+            rtts.push_back(r.second);
+            total += r.second;
+        }
+        sort(rtts.begin(), rtts.end());
+        auto pct = [&](double q) { return rtts[min(rtts.size() - 1, (size_t)(q * rtts.size()))]; };
+        char line[160];
+        snprintf(line, sizeof(line), "min %.3f  avg %.3f  p50 %.3f  p99 %.3f  max %.3f (ms)",
+                 rtts.front(), total / rtts.size(), pct(0.50), pct(0.99), rtts.back());
+        cout << line << endl;
+
+        double elapsed = chrono::duration<double>(lastEchoAt - firstSendAt).count();
+        if (elapsed > 0) {
+            snprintf(line, sizeof(line), "throughput %.1f msg/s over %.3f s", results.size() / elapsed, elapsed);
+            cout << line << endl;
+        }
+    }
+
+public:
+    HeadlessClient(double replaySpeed = 1.0, const SendOptions& opts = SendOptions(), int replyTimeoutMs = 5000)
+        : network(nullptr), speed(replaySpeed > 0 ? replaySpeed : 1.0), timeoutMs(replyTimeoutMs), sendOptions(opts),
+          serverReplies(0), disconnected(false), nameConfirmed(false) {}
+    ~HeadlessClient() { delete network; }
+
+    bool loadScript(const string& path) {
+        ifstream in(path);
+        if (!in) return false;
+        string line;
+        long long sleepMs = 0;
+        while (getline(in, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty() || line[0] == '#') continue;
+            if (line.rfind(".SLEEP ", 0) == 0) {
+                sleepMs += atoll(line.c_str() + 7);
+                continue;
+            }
+            entries.push_back({-1, sleepMs, line});
+            sleepMs = 0;
+        }
+        return true;
+    }
+
+    bool loadRecording(const string& path) {
+        ifstream in(path);
+        if (!in) return false;
+        string line;
+        while (getline(in, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            size_t tab = line.find('\t');
+            if (line.empty() || line[0] == '#' || tab == string::npos || tab + 1 >= line.size()) continue;
+            entries.push_back({atoll(line.substr(0, tab).c_str()), 0, line.substr(tab + 1)});
+        }
+        return true;
+    }
+
+    int run(const char* ip, int port, const string& user) {
+        // Chunks are only handed to onReceive; keeping them too would grow without bound on long runs
+        network = new NetworkManager(nullptr, nullptr, sendOptions);
+        network->setReceiveCallback([this](const string& chunk) { onReceive(chunk); });
+        if (!network->connectToServer(ip, port, user)) {
+            cerr << "Failed to connect to server " << ip << ":" << port << endl;
+            return 1;
+        }
+
+        // Let the welcome (and username reply) arrive before the first scripted send
+        {
+            unique_lock<mutex> lock(stateMutex);
+            stateChanged.wait_for(lock, chrono::milliseconds(timeoutMs), [&] {
+                return disconnected || (!username.empty() && (user.empty() || nameConfirmed));
+            });
+        }
+
+        Clock::time_point start = Clock::now();
+        for (const auto& e : entries) {
+            {
+                lock_guard<mutex> lock(stateMutex);
+                if (disconnected) break;
+            }
+            if (e.atMs >= 0)
+                this_thread::sleep_until(start + chrono::microseconds((long long)(e.atMs * 1000 / speed)));
+            else if (e.sleepMs > 0)
+                this_thread::sleep_for(chrono::milliseconds(e.sleepMs));
+
+            if (e.text == ".EXIT") break;
+            sendEntry(e.text);
+        }
+
+        // Give outstanding echoes a chance to come back
+        {
+            unique_lock<mutex> lock(stateMutex);
+            stateChanged.wait_for(lock, chrono::milliseconds(timeoutMs),
+                                  [&] { return pending.empty() || disconnected; });
+        }
+        // Closing the socket is enough for the server to clean up the session
+        network->disconnect();
+
+        printReport();
+        return 0;
+    }
+};
+
 // --- Base UI Component --- 
 class UIComponent {
 protected:
@@ -105,6 +518,16 @@ public:
     }
     virtual void draw() = 0;
     void refreshWin() { wrefresh(window); }
+
+    // Resizes and moves the existing window in place after a terminal resize
+    void relayout(int h, int w, int y, int x) {
+        height = h; width = w; startY = y; startX = x;
+        wresize(window, h, w);
+        mvwin(window, y, x);
+        onResize();
+    }
+    // Hook for components with state that depends on their size
+    virtual void onResize() {}
 };
 
 // --- Header Area --- 
@@ -176,9 +599,34 @@ private:
     mutex* mtx;
     int scrollOffset;
 
+    // Splits one message into display rows: on embedded newlines first,
+    // then at the last space that fits (or hard at `cols` for long words)
+    static void wrapMessage(const string& msg, int cols, vector<string>& rows) {
+        size_t start = 0;
+        while (start <= msg.size()) {
+            size_t nl = msg.find('\n', start);
+            if (nl == string::npos) nl = msg.size();
+            string segment = msg.substr(start, nl - start);
+            if (!segment.empty() && segment.back() == '\r') segment.pop_back();
+            while ((int)segment.size() > cols) {
+                size_t cut = segment.rfind(' ', cols);
+                if (cut == string::npos || cut == 0) cut = cols;
+                rows.push_back(segment.substr(0, cut));
+                segment.erase(0, segment[cut] == ' ' ? cut + 1 : cut);
+            }
+            if (!segment.empty()) rows.push_back(segment);
+            start = nl + 1;
+        }
+    }
+
 public:
     MessageArea(int h,int w,int y,int x,vector<string>* m,mutex* mut) : UIComponent(h,w,y,x), messages(m), mtx(mut), scrollOffset(0) {}
 
+    void onResize() override {
+        lock_guard<mutex> lock(*mtx);
+        scrollOffset = max(0, min(scrollOffset, (int)messages->size() - (height - 2)));
+    }
+
     void scrollUp() {
         if(scrollOffset < (int)messages->size() - (height - 2)) scrollOffset++;
     }
@@ -192,12 +640,20 @@ public:
         box(window, 0, 0);
         mvwprintw(window, 0, 2, "[ Messages ]");
         lock_guard<mutex> lock(*mtx);
-        int start = max(0, (int)messages->size() - (height - 2) - scrollOffset);
-        int end = min((int)messages->size(), start + height - 2);
-        int line = 1;
+        int rows = height - 2, cols = max(1, width - 4);
 
-        for(int i = start; i < end; i++)
-            mvwprintw(window, line++, 2, "%s", messages->at(i).c_str());
+        // Wrap only as many messages as fit, walking back from the newest shown one,
+        // so a redraw (or a resize) costs what is on screen rather than the history
+        vector<string> visible, wrapped;
+        for (int i = (int)messages->size() - 1 - scrollOffset; i >= 0 && (int)visible.size() < rows; i--) {
+            wrapped.clear();
+            wrapMessage(messages->at(i), cols, wrapped);
+            for (auto it = wrapped.rbegin(); it != wrapped.rend() && (int)visible.size() < rows; ++it)
+                visible.push_back(*it);
+        }
+        int line = 1;
+        for (auto it = visible.rbegin(); it != visible.rend(); ++it)
+            mvwaddnstr(window, line++, 2, it->c_str(), cols);
 
         if(scrollOffset > 0) mvwprintw(window, 1, width-3, "^");
         if((int)messages->size() - scrollOffset > height-2) mvwprintw(window, height-2, width-3, "v");
@@ -206,46 +662,156 @@ public:
     }
 };
 
+// --- Gap Buffer --- 
+// Text storage for the input line. The free "gap" sits at the cursor, so
+// inserting or deleting there only touches the gap; moving the cursor moves
+// the gap with a single memmove. A bulk insert (e.g. a paste) is one copy.
+class GapBuffer {
+private:
+    vector<char> buf;
+    size_t gapStart, gapEnd;
+
+    void moveGap(size_t pos) {
+        if (pos < gapStart) {
+            size_t n = gapStart - pos;
+            memmove(&buf[gapEnd - n], &buf[pos], n);
+            gapStart -= n;
+            gapEnd -= n;
+        } else if (pos > gapStart) {
+            size_t n = pos - gapStart;
+            memmove(&buf[gapStart], &buf[gapEnd], n);
+            gapStart += n;
+            gapEnd += n;
+        }
+    }
+
+    void reserveGap(size_t need) {
+        if (gapEnd - gapStart >= need) return;
+        size_t tail = buf.size() - gapEnd;
+        size_t newSize = max(buf.size() * 2, size() + need + 64);
+        buf.resize(newSize);
+        memmove(&buf[newSize - tail], &buf[gapEnd], tail);
+        gapEnd = newSize - tail;
+    }
+
+public:
+    GapBuffer() : buf(64), gapStart(0), gapEnd(64) {}
+
+    size_t size() const { return buf.size() - (gapEnd - gapStart); }
+
+    void insert(size_t pos, const char* text, size_t n) {
+        if (n == 0) return;
+        reserveGap(n);
+        moveGap(pos);
+        memcpy(&buf[gapStart], text, n);
+        gapStart += n;
+    }
+
+    void erase(size_t pos, size_t n) {
+        n = min(n, size() - pos);
+        moveGap(pos);
+        gapEnd += n;
+    }
+
+    // Copies [pos, pos + n) out of the buffer, skipping the gap
+    string substr(size_t pos, size_t n) const {
+        n = min(n, size() - pos);
+        string out;
+        out.reserve(n);
+        size_t end = pos + n;
+        if (pos < gapStart) out.append(&buf[pos], min(end, gapStart) - pos);
+        if (end > gapStart) {
+            size_t from = max(pos, gapStart);
+            out.append(&buf[from + (gapEnd - gapStart)], end - from);
+        }
+        return out;
+    }
+
+    string str() const { return substr(0, size()); }
+
+    void clear() {
+        gapStart = 0;
+        gapEnd = buf.size();
+    }
+};
+
 // --- Input Area --- 
 class InputArea : public UIComponent {
 private:
-    string currentInput;
+    GapBuffer text;
     int cursorPos;
+    int scrollX; // index of the first character shown
+
+    int visibleWidth() const { return max(1, width - 6); } // box + "> " + room for the cursor
+
+    // Keeps the cursor inside the visible slice
+    void keepCursorVisible() {
+        int w = visibleWidth();
+        if (cursorPos < scrollX) scrollX = cursorPos;
+        if (cursorPos >= scrollX + w) scrollX = cursorPos - w + 1;
+    }
 
 public:
-    InputArea(int w,int y) : UIComponent(3,w,y,0), cursorPos(0) {}
+    InputArea(int w,int y) : UIComponent(3,w,y,0), cursorPos(0), scrollX(0) {}
+
+    void onResize() override {
+        scrollX=0;
+        keepCursorVisible();
+    }
 
     void draw() override {
         werase(window);
         box(window,0,0);
         mvwprintw(window,0,2,"[ Compose Message ]");
-        mvwprintw(window,1,2,"> %s",currentInput.c_str());
-        wmove(window,1,3+cursorPos);
+        // Only the visible slice is copied and printed, however long the input is
+        string visible=text.substr(scrollX,visibleWidth());
+        mvwprintw(window,1,2,"> ");
+        waddnstr(window,visible.c_str(),(int)visible.size());
+        if(scrollX>0) mvwaddch(window,1,1,'<');
+        if((int)text.size()>scrollX+visibleWidth()) mvwaddch(window,1,width-1,'>');
+        wmove(window,1,4+cursorPos-scrollX);
         refreshWin();
     }
 
     void addChar(char ch){
-        currentInput.insert(cursorPos,1,ch);
-        cursorPos++;
+        insertText(string(1,ch));
+    }
+    // Inserts a run of characters at the cursor in one operation; control
+    // characters are dropped and tabs become spaces
+    void insertText(const string& s){
+        string clean;
+        clean.reserve(s.size());
+        for(char c: s){
+            if(c=='\t') clean+=' ';
+            else if((unsigned char)c>=32 && c!=127) clean+=c;
+        }
+        text.insert(cursorPos,clean.data(),clean.size());
+        cursorPos+=(int)clean.size();
+        keepCursorVisible();
     }
     void backspace(){
         if(cursorPos>0){
-            currentInput.erase(cursorPos-1,1);
+            text.erase(cursorPos-1,1);
             cursorPos--;
+            keepCursorVisible();
         }
     }
     void deleteChar(){
-        if(cursorPos<(int)currentInput.size()) currentInput.erase(cursorPos,1);
+        if(cursorPos<(int)text.size()) text.erase(cursorPos,1);
     }
     void moveCursorLeft(){
         if(cursorPos>0) cursorPos--;
+        keepCursorVisible();
     }
     void moveCursorRight(){
-        if(cursorPos<(int)currentInput.size()) cursorPos++;
+        if(cursorPos<(int)text.size()) cursorPos++;
+        keepCursorVisible();
     }
-    void clear(){ currentInput.clear(); cursorPos=0; }
+    void moveCursorHome(){ cursorPos=0; keepCursorVisible(); }
+    void moveCursorEnd(){ cursorPos=(int)text.size(); keepCursorVisible(); }
+    void clear(){ text.clear(); cursorPos=0; scrollX=0; }
     string getInput(){
-        string tmp=currentInput;
+        string tmp=text.str();
         clear();
         return tmp;
     }
@@ -275,7 +841,27 @@ public:
     }
 };
 
+// --- Layout --- 
+// Window geometry for a terminal size. The header, input and info bars keep
+// a fixed height; the room list and message area share the remaining rows.
+struct Layout {
+    int maxH, maxW;
+    int headerH = 3, inputH = 3, infoH = 8, roomW = 25;
+    int mainContentH;
+
+    Layout(int h, int w) : maxH(h), maxW(w) {
+        mainContentH = max(3, maxH - headerH - inputH - infoH);
+    }
+    int inputY() const { return headerH + mainContentH; }
+    int infoY() const { return inputY() + inputH; }
+    int messageW() const { return max(10, maxW - roomW); }
+};
+
 // --- Chat Client UI Controller --- 
+// Key codes bound to the bracketed-paste start/end sequences
+const int KEY_PASTE_START = KEY_MAX + 1;
+const int KEY_PASTE_END = KEY_MAX + 2;
+
 class ChatClientUI {
 private:
     HeaderArea* header;
@@ -286,10 +872,21 @@ private:
     NetworkManager* network;
     vector<string> messages;
     mutex messagesMutex;
+    size_t processedMessages; // messages already passed to processServerMessage
     vector<string> serverRooms;
     string currentRoom;
     string username;
     atomic<bool> isRunning;
+    ofstream recordFile;
+    chrono::steady_clock::time_point sessionStart;
+
+    // Appends a submitted line to the session recording in HeadlessClient's replay format
+    void recordInput(const string& input){
+        if(!recordFile.is_open()) return;
+        long long ms=chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now()-sessionStart).count();
+        recordFile<<ms<<'\t'<<input<<'\n';
+        recordFile.flush();
+    }
 
     void initCurses(){
         initscr();
@@ -300,6 +897,12 @@ private:
         init_pair(1,COLOR_CYAN,COLOR_BLACK);
         init_pair(2,COLOR_GREEN,COLOR_BLACK);
         init_pair(3,COLOR_YELLOW,COLOR_BLACK);
+
+        // Bracketed paste: the terminal wraps pasted text in ESC[200~ ... ESC[201~
+        define_key("\033[200~",KEY_PASTE_START);
+        define_key("\033[201~",KEY_PASTE_END);
+        printf("\033[?2004h");
+        fflush(stdout);
         refresh();
     }
 
@@ -360,8 +963,89 @@ private:
         }
     }
 
+    void submitInput(const string& input){
+        if(input.empty()) return;
+        recordInput(input);
+
+        if(input[0]=='.'){
+            sendCommand(input);
+        } else{
+            if(currentRoom=="Lobby"){
+                lock_guard<mutex> lock(messagesMutex);
+                messages.push_back("[SERVER] You must join a room first!");
+            } else {
+                network->sendMessage(input);
+                lock_guard<mutex> lock(messagesMutex);
+                messages.push_back("You: "+input);
+            }
+        }
+    }
+
+    // Reads a bracketed paste up to its end marker and ingests it in bulk.
+    // Every complete pasted line is submitted as if Enter was pressed; the
+    // unterminated remainder stays in the input box.
+    void handlePaste(){
+        string pasted;
+        timeout(200); // the rest of the paste may still be in flight
+        int ch;
+        while((ch=getch())!=ERR && ch!=KEY_PASTE_END){
+            if(ch=='\r' || ch==KEY_ENTER) pasted+='\n';
+            else if(ch<256) pasted+=static_cast<char>(ch);
+        }
+        nodelay(stdscr,TRUE);
+
+        size_t start=0,newline;
+        while((newline=pasted.find('\n',start))!=string::npos){
+            inputArea->insertText(pasted.substr(start,newline-start));
+            submitInput(inputArea->getInput());
+            start=newline+1;
+        }
+        inputArea->insertText(pasted.substr(start));
+    }
+
+    // ncurses turns SIGWINCH into KEY_RESIZE after updating LINES/COLS; the
+    // existing windows are resized and moved in place, keeping all state
+    void onResize(){
+        int maxH,maxW;
+        getmaxyx(stdscr,maxH,maxW);
+        Layout l(maxH,maxW);
+
+        header->relayout(l.headerH,l.maxW,0,0);
+        roomList->relayout(l.mainContentH,l.roomW,l.headerH,0);
+        messageArea->relayout(l.mainContentH,l.messageW(),l.headerH,l.roomW);
+        inputArea->relayout(l.inputH,l.maxW,l.inputY(),0);
+        infoArea->relayout(l.infoH,l.maxW,l.infoY(),0);
+
+        // Drop stale characters outside the new layout; the next frame redraws every window
+        clear();
+        refresh();
+    }
+
+    void handleKey(int ch){
+        switch(ch){
+            case KEY_RESIZE: onResize(); break;
+            case KEY_F(1): infoArea->addInfo("[HELP] Use commands starting with '.'"); break;
+            case KEY_F(2): sendCommand(".LIST_ROOMS"); break;
+            case KEY_F(10): sendCommand(".EXIT"); break;
+            case KEY_PPAGE: messageArea->scrollUp(); break;
+            case KEY_NPAGE: messageArea->scrollDown(); break;
+            case 27: inputArea->clear(); break; // ESC key
+            case KEY_BACKSPACE: case 127: inputArea->backspace(); break;
+            case KEY_DC: inputArea->deleteChar(); break; // Delete key
+            case KEY_LEFT: inputArea->moveCursorLeft(); break;
+            case KEY_RIGHT: inputArea->moveCursorRight(); break;
+            case KEY_HOME: inputArea->moveCursorHome(); break;
+            case KEY_END: inputArea->moveCursorEnd(); break;
+            case KEY_UP: roomList->moveSelection(-1); break;
+            case KEY_DOWN: roomList->moveSelection(1); break;
+            case KEY_PASTE_START: handlePaste(); break;
+            case '\n': case KEY_ENTER: submitInput(inputArea->getInput()); break;
+            default: break;
+        }
+    }
+
 public:
-    ChatClientUI(int argc,char* argv[]):currentRoom("Lobby"),isRunning(true){
+    ChatClientUI(int argc,char* argv[],const string& recordPath="",const SendOptions& sendOptions=SendOptions()):processedMessages(0),currentRoom("Lobby"),isRunning(true),sessionStart(chrono::steady_clock::now()){
         #ifdef _WIN32 
         WSADATA data; 
         WSAStartup(MAKEWORD(2,2),&data); 
@@ -376,9 +1060,11 @@ public:
         if(argc>=2) ip=argv[1];
         if(argc>=3) port=atoi(argv[2]);
         if(argc>=4) user=argv[3];
+        if(!recordPath.empty()) recordFile.open(recordPath);
 
-        network=new NetworkManager(&messages,&messagesMutex);
+        network=new NetworkManager(&messages,&messagesMutex,sendOptions);
         if(!network->connectToServer(ip,port,user)){
+            printf("\033[?2004l");
             endwin();
             cout<<"Failed to connect to server "<<ip<<":"<<port<<endl;
             exit(1);
@@ -386,18 +1072,16 @@ public:
 
         int maxH,maxW;
         getmaxyx(stdscr,maxH,maxW);
+        Layout l(maxH,maxW);
 
-        int headerH=3,inputH=3,infoH=8;
-        int mainContentH=maxH-headerH-inputH-infoH;
-
-        header=new HeaderArea(maxW);
+        header=new HeaderArea(l.maxW);
         header->setUsername(user.empty()?"Connecting...":user);
         header->setCurrentRoom(currentRoom);
 
-        roomList=new RoomList(mainContentH,headerH);
-        messageArea=new MessageArea(mainContentH,maxW-25,headerH,25,&messages,&messagesMutex);
-        inputArea=new InputArea(maxW,maxH-inputH-infoH);
-        infoArea=new InfoArea(infoH,maxW,maxH-infoH,0);
+        roomList=new RoomList(l.mainContentH,l.headerH);
+        messageArea=new MessageArea(l.mainContentH,l.messageW(),l.headerH,l.roomW,&messages,&messagesMutex);
+        inputArea=new InputArea(l.maxW,l.inputY());
+        infoArea=new InfoArea(l.infoH,l.maxW,l.infoY(),0);
 
         messages.push_back("[INFO] Connected to chat server.");
         messages.push_back("[INFO] Type .HELP for commands.");
@@ -418,6 +1102,8 @@ public:
         delete inputArea;
         delete infoArea;
         delete network;
+        printf("\033[?2004l");
+        fflush(stdout);
         endwin();
         #ifdef _WIN32
         WSACleanup();
@@ -425,11 +1111,13 @@ public:
     }
 
     void run(){
+        nodelay(stdscr, TRUE); // Non-blocking input
         while(isRunning){
             // --- Auto-update messages --- 
             {
                 lock_guard<mutex> lock(messagesMutex);
-                for(const auto& msg: messages) processServerMessage(msg);
+                for(; processedMessages<messages.size(); processedMessages++)
+                    processServerMessage(messages[processedMessages]);
             }
             
             // --- Draw UI --- 
@@ -440,88 +1128,72 @@ public:
             infoArea->draw();
 
             // --- Handle input --- 
-            nodelay(stdscr, TRUE); // Non-blocking input
-            int ch = getch();
-
-            if(ch != ERR){
-                if(ch==KEY_F(1)){
-                    infoArea->addInfo("[HELP] Use commands starting with '.'");
-                    continue;
-                }
-                if(ch==KEY_F(2)){
-                    sendCommand(".LIST_ROOMS");
-                    continue;
-                }
-                if(ch==KEY_F(10)){
-                    sendCommand(".EXIT");
-                    continue;
-                }
-                if(ch==KEY_PPAGE){
-                    messageArea->scrollUp();
-                    continue;
-                }
-                if(ch==KEY_NPAGE){
-                    messageArea->scrollDown();
-                    continue;
-                }
-                if(ch==27){ // ESC key
-                    inputArea->clear();
-                    continue;
-                }
-                if(ch==KEY_BACKSPACE || ch==127){
-                    inputArea->backspace();
-                    continue;
-                }
-                if(ch==KEY_DC){ // Delete key
-                    inputArea->deleteChar();
-                    continue;
-                }
-                if(ch==KEY_LEFT){
-                    inputArea->moveCursorLeft();
-                    continue;
-                }
-                if(ch==KEY_RIGHT){
-                    inputArea->moveCursorRight();
-                    continue;
-                }
-                if(ch==KEY_UP){
-                    roomList->moveSelection(-1);
-                    continue;
-                }
-                if(ch==KEY_DOWN){
-                    roomList->moveSelection(1);
+            // Drain every queued key before the next redraw; runs of printable
+            // characters (typing or an unbracketed paste) are inserted in one go
+            string typed;
+            bool gotInput=false;
+            int ch;
+            while(isRunning && (ch=getch())!=ERR){
+                gotInput=true;
+                if(ch>=32 && ch<=126){
+                    typed+=static_cast<char>(ch);
                     continue;
                 }
-                if(ch=='\n' || ch==KEY_ENTER){
-                    string input=inputArea->getInput();
-                    if(input.empty()) continue;
-
-                    if(input[0]=='.'){
-                        sendCommand(input);
-                    } else{
-                        if(currentRoom=="Lobby"){
-                            lock_guard<mutex> lock(messagesMutex);
-                            messages.push_back("[SERVER] You must join a room first!");
-                        } else {
-                            network->sendMessage(input);
-                            lock_guard<mutex> lock(messagesMutex);
-                            messages.push_back("You: "+input);
-                        }
-                    }
-                    continue;
+                if(!typed.empty()){
+                    inputArea->insertText(typed);
+                    typed.clear();
                 }
-                if(ch>=32 && ch<=126) 
-                    inputArea->addChar(static_cast<char>(ch));
+                handleKey(ch);
             }
+            if(!typed.empty()) inputArea->insertText(typed);
 
-            this_thread::sleep_for(chrono::milliseconds(50));
+            if(!gotInput) this_thread::sleep_for(chrono::milliseconds(50));
         }
     }
 };
 
 // --- Main --- 
+// Usage: chatclient [ip] [port] [username] [--record <file>] [--nagle] [--cork <ms>]
+//        chatclient [ip] [port] [username] --script <file> | --replay <file> [--speed <x>] [--nagle] [--cork <ms>]
 int main(int argc,char* argv[]){
-    ChatClientUI app(argc,argv);
+    vector<char*> args;
+    string scriptPath,replayPath,recordPath;
+    double speed=1.0;
+    SendOptions sendOptions;
+    for(int i=0;i<argc;i++){
+        string arg=argv[i];
+        if(arg=="--script" && i+1<argc) scriptPath=argv[++i];
+        else if(arg=="--replay" && i+1<argc) replayPath=argv[++i];
+        else if(arg=="--record" && i+1<argc) recordPath=argv[++i];
+        else if(arg=="--speed" && i+1<argc) speed=atof(argv[++i]);
+        else if(arg=="--nagle") sendOptions.noDelay=false;
+        else if(arg=="--cork" && i+1<argc) sendOptions.corkMs=max(0,atoi(argv[++i]));
+        else args.push_back(argv[i]);
+    }
+
+    if(!scriptPath.empty() || !replayPath.empty()){
+        #ifdef _WIN32
+        WSADATA data;
+        WSAStartup(MAKEWORD(2,2),&data);
+        #endif
+        const char* ip=args.size()>=2?args[1]:"127.0.0.1";
+        int port=args.size()>=3?atoi(args[2]):5400;
+        string user=args.size()>=4?args[3]:"";
+
+        HeadlessClient client(speed,sendOptions);
+        bool loaded=scriptPath.empty()?client.loadRecording(replayPath):client.loadScript(scriptPath);
+        if(!loaded){
+            cerr<<"Cannot open "<<(scriptPath.empty()?replayPath:scriptPath)<<endl;
+            return 1;
+        }
+        int rc=client.run(ip,port,user);
+        #ifdef _WIN32
+        WSACleanup();
+        #endif
+        return rc;
+    }
+
+    ChatClientUI app((int)args.size(),args.data(),recordPath,sendOptions);
     app.run();
     return 0;
 }
\ No newline at end of file
@@ -7,10 +7,12 @@
 #include <algorithm>
 #include <unordered_map>
 #include <sstream> // For generating unique IDs
+#include <cstring>
 #ifdef _WIN32
 #include <winsock2.h>
 #include <ws2tcpip.h>
 #pragma comment(lib, "Ws2_32.lib")
+#define SHUT_RDWR SD_BOTH
 #else
 #include <sys/socket.h>
 #include <arpa/inet.h>
@@ -87,6 +89,10 @@ private:
     mutex globalMutex;
     SOCKET listeningSocket;
 
+    // Longest line a client may send; a client that exceeds it without a '\n'
+    // is disconnected instead of growing its buffer without bound
+    static const size_t MAX_LINE_LENGTH = 64 * 1024;
+
     // Helper to generate a unique default username
     string getUniqueDefaultUsername() {
         static int anonCount = 1000;
@@ -101,6 +107,7 @@ private:
     // Handles an incoming message from a client
     void handleClient(User* user) {
         char buffer[4096];
+        string pending; // bytes received after the last '\n'
 
         // Place new user in the Lobby (which is auto-created)
         joinRoom(user, "Lobby");
@@ -118,19 +125,42 @@ private:
                 break;
             }
 
-            string msg(buffer, bytesReceived);
-            // Commands
-            if (msg.rfind('.', 0) == 0) {
-                processCommand(user, msg);
+            // Clients frame each line with '\n' and may batch several lines in one write,
+            // so a single recv() can hold several messages or only part of one
+            pending.append(buffer, bytesReceived);
+            size_t start = 0, newline;
+            bool exiting = false;
+            while (!exiting && (newline = pending.find('\n', start)) != string::npos) {
+                string msg = pending.substr(start, newline - start);
+                start = newline + 1;
+                if (!msg.empty() && msg.back() == '\r') msg.pop_back();
+                if (msg.empty()) continue;
+                exiting = (msg == ".EXIT");
+                handleMessage(user, msg);
+            }
+            pending.erase(0, exiting ? pending.size() : start);
+            if (pending.size() > MAX_LINE_LENGTH) {
+                cout << user->username << " sent a line over " << MAX_LINE_LENGTH << " bytes; disconnecting." << endl;
+                user->send("[SERVER] Line too long; disconnecting.\n");
+                cleanUpUser(user);
+                break;
+            }
+        }
+    }
+
+    // Dispatches one complete line from a client
+    void handleMessage(User* user, const string& msg) {
+        // Commands
+        if (msg.rfind('.', 0) == 0) {
+            processCommand(user, msg);
+        } else {
+            // Regular chat message
+            if (user->currentRoom) {
+                string fullMsg = user->username + ": " + msg;
+                user->currentRoom->broadcast(fullMsg + "\n");
+                cout << "Broadcasted to " << user->currentRoom->getName() << ": " << fullMsg << endl;
             } else {
-                // Regular chat message
-                if (user->currentRoom) {
-                    string fullMsg = user->username + ": " + msg;
-                    user->currentRoom->broadcast(fullMsg);
-                    cout << "Broadcasted to " << user->currentRoom->getName() << ": " << fullMsg << endl;
-                } else {
-                    user->send("[SERVER] You must join a room first!\n");
-                }
+                user->send("[SERVER] You must join a room first!\n");
             }
         }
     }
@@ -168,8 +198,8 @@ private:
 
         } else if (msg == ".EXIT") {
             cout << user->username << " requested disconnect." << endl;
-            closesocket(user->sock);
-            cleanUpUser(user);
+            // handleClient's recv() then returns 0 and cleans the user up exactly once
+            shutdown(user->sock, SHUT_RDWR);
         } else {
             user->send("[SERVER] Unknown command: " + msg + "\n");
         }
@@ -0,0 +1,212 @@
+#include "Checkpoint.h"
+#include "CompressedInput.h"
+#include "MappedFile.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+// File layout (tab separated, one file per line, path last so it may hold tabs):
+//   LogAnalyzer checkpoint 1
+//   keywords <k0> <k1> ...
+//   file <inode> <size> <mtime> <offset> <c0>,<c1>,... <path>
+namespace {
+const char* const HEADER = "LogAnalyzer checkpoint 1";
+}
+
+bool Checkpoint::load(const std::vector<std::string>& keywords) {
+    entries.clear();
+    std::ifstream in(path);
+    if (!in) return false;
+
+    std::string line;
+    if (!std::getline(in, line) || line != HEADER) return false;
+
+    std::string expected = "keywords";
+    for (const auto& k : keywords) expected += "\t" + k;
+    if (!std::getline(in, line) || line != expected) return false;
+
+    std::map<std::string, Entry> loaded;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string tag, counts, filePath;
+        Entry entry;
+        if (!(fields >> tag >> entry.id >> entry.size >> entry.mtime >> entry.offset >> counts) || tag != "file")
+            return false;
+        fields.get(); // the tab before the path
+        std::getline(fields, filePath);
+
+        std::istringstream values(counts);
+        std::string value;
+        while (std::getline(values, value, ','))
+            entry.counts.push_back(std::atoll(value.c_str()));
+        if (entry.counts.size() != keywords.size() || entry.offset > entry.size || filePath.empty())
+            return false;
+        loaded.emplace(filePath, std::move(entry));
+    }
+    entries = std::move(loaded);
+    return true;
+}
+
+bool Checkpoint::save(const std::vector<std::string>& keywords) const {
+    std::string temp = path + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::trunc);
+        if (!out) return false;
+        out << HEADER << "\n" << "keywords";
+        for (const auto& k : keywords) out << "\t" << k;
+        out << "\n";
+        for (const auto& [filePath, e] : entries) {
+            out << "file\t" << e.id << "\t" << e.size << "\t" << e.mtime << "\t" << e.offset << "\t";
+            for (size_t i = 0; i < e.counts.size(); ++i)
+                out << (i ? "," : "") << e.counts[i];
+            out << "\t" << filePath << "\n";
+        }
+        if (!out.flush()) return false;
+    }
+    // rename replaces the old checkpoint in one step
+#ifdef _WIN32
+    return MoveFileExA(temp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return std::rename(temp.c_str(), path.c_str()) == 0;
+#endif
+}
+
+Checkpoint::Stats Checkpoint::update(LogAnalyzer& analyzer, const std::vector<LogFile>& files,
+                                     WorkStealingPool& pool) {
+    Stats stats;
+    const size_t keywordCount = analyzer.keywords().size();
+    std::map<std::string, Entry> current;
+    LogAnalyzer::WorkerState cached = analyzer.newWorkerState();
+
+    // [begin, end) of a file still to scan
+    struct Tail {
+        Entry* entry;
+        std::string path;
+        unsigned long long begin, end;
+    };
+    std::vector<Tail> tails;
+
+    for (const auto& f : files) {
+        FileStat st;
+        if (!statFile(f.path, st)) continue;
+
+        Entry& entry = current[f.path];
+        auto old = entries.find(f.path);
+        // A compressed file cannot be resumed mid-stream, so any change rescans it
+        bool compressed = compressionOf(f.path) != Compression::NONE;
+        bool sameFile = old != entries.end() && old->second.id == st.id && st.size >= old->second.size;
+        if (sameFile && compressed)
+            sameFile = st.size == old->second.size && st.mtime == old->second.mtime && old->second.offset == st.size;
+        if (sameFile) {
+            // Same file, same or longer: keep the counted prefix
+            entry = old->second;
+            if (st.size == old->second.size && st.mtime == old->second.mtime) stats.unchanged++;
+            else stats.appended++;
+        } else {
+            entry.counts.assign(keywordCount, 0);
+            entry.offset = 0;
+            stats.rescanned++;
+        }
+        entry.id = st.id;
+        entry.size = st.size;
+        entry.mtime = st.mtime;
+
+        for (size_t k = 0; k < keywordCount; ++k)
+            cached.counts[k] += entry.counts[k];
+        // A trailing line without a newline is never committed, so it is
+        // rescanned (and counted) on every run until it is complete
+        if (entry.offset < st.size) tails.push_back({&entry, f.path, entry.offset, st.size});
+    }
+    for (const auto& [filePath, e] : entries)
+        if (!current.count(filePath)) stats.removed++;
+
+    // Tails are scanned like analyzeFiles scans whole files: one task per
+    // file, split into CHUNK_SIZE pieces. Each chunk's counts are added to
+    // its file's entry as well as to the worker's totals.
+    std::vector<LogAnalyzer::WorkerState> states(pool.size(), analyzer.newWorkerState());
+    std::mutex entryMutex;
+    std::atomic<unsigned long long> bytesScanned{0};
+
+    auto scanCommitted = [&](Entry* entry, const char* begin, const char* end) {
+        LogAnalyzer::WorkerState& state = states[WorkStealingPool::currentWorker()];
+        std::vector<long long> before = state.counts;
+        analyzer.scanChunk(begin, end, state);
+        std::lock_guard<std::mutex> lock(entryMutex);
+        for (size_t k = 0; k < keywordCount; ++k)
+            entry->counts[k] += state.counts[k] - before[k];
+    };
+
+    auto scanTail = [&](const Tail& t) {
+        if (compressionOf(t.path) != Compression::NONE) {
+            // Decompressed and counted whole on this worker; committed only
+            // when the stream ended cleanly
+            LogAnalyzer::WorkerState& state = states[WorkStealingPool::currentWorker()];
+            std::vector<long long> before = state.counts;
+            unsigned long long bytes = 0;
+            bool complete = analyzer.scanCompressed(t.path, state, bytes);
+            {
+                std::lock_guard<std::mutex> lock(entryMutex);
+                for (size_t k = 0; k < keywordCount; ++k)
+                    t.entry->counts[k] += state.counts[k] - before[k];
+            }
+            t.entry->offset = complete ? t.end : 0;
+            bytesScanned += bytes;
+            return;
+        }
+
+        auto file = std::make_shared<MappedFile>(t.path);
+        if (!file->isOpen()) {
+            std::cerr << "Error: Could not open file " << t.path << "\n";
+            return;
+        }
+        // Stop at the size seen by stat; anything written since is left for the next run
+        unsigned long long endOffset = std::min<unsigned long long>(t.end, file->size());
+        if (endOffset < t.begin) return; // shrank meanwhile; rescanned next run
+        const char* begin = file->data() + t.begin;
+        const char* end = file->data() + endOffset;
+
+        const char* committed = end;
+        while (committed > begin && committed[-1] != '\n') --committed;
+
+        const char* p = begin;
+        while (p < committed) {
+            const char* cut = committed;
+            if (static_cast<size_t>(committed - p) > LogAnalyzer::CHUNK_SIZE) {
+                cut = static_cast<const char*>(
+                    std::memchr(p + LogAnalyzer::CHUNK_SIZE, '\n', committed - (p + LogAnalyzer::CHUNK_SIZE))) + 1;
+            }
+            pool.submit([&, file, entry = t.entry, p, cut]() { scanCommitted(entry, p, cut); });
+            p = cut;
+        }
+        // The partial last line counts toward this run's totals only
+        if (committed < end)
+            analyzer.scanChunk(committed, end, states[WorkStealingPool::currentWorker()]);
+
+        t.entry->offset = t.begin + static_cast<unsigned long long>(committed - begin);
+        t.entry->size = endOffset;
+        bytesScanned += endOffset - t.begin;
+    };
+
+    for (const auto& t : tails)
+        pool.submit([&, t]() { scanTail(t); });
+    pool.wait();
+
+    states.push_back(std::move(cached));
+    analyzer.mergeStates(states);
+    entries = std::move(current);
+    stats.bytesScanned = bytesScanned;
+    return stats;
+}
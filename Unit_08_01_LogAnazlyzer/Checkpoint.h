@@ -0,0 +1,56 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+#include "LogAnalyzer.h"
+
+class WorkStealingPool;
+
+// Per-file scan state kept between runs: identity, size, mtime, how far the
+// file has been scanned and the keyword counts of that prefix. A re-run only
+// reads bytes past the recorded offset and adds the cached counts of the
+// rest, so an unchanged directory costs one stat per file.
+// Logs are assumed to be append-only: a file that keeps its inode and does
+// not shrink is trusted to still start with the bytes already counted.
+class Checkpoint {
+public:
+    struct Stats {
+        size_t unchanged = 0; // counts taken from the checkpoint
+        size_t appended = 0;  // only the new tail scanned
+        size_t rescanned = 0; // new, rotated or truncated files scanned whole
+        size_t removed = 0;   // recorded files that no longer exist
+        unsigned long long bytesScanned = 0;
+    };
+
+private:
+    struct Entry {
+        unsigned long long id = 0;     // inode, 0 where unavailable
+        unsigned long long size = 0;
+        long long mtime = 0;           // nanoseconds
+        unsigned long long offset = 0; // end of the last complete line counted
+        std::vector<long long> counts; // keyword counts of [0, offset)
+    };
+
+    std::string path;
+    std::map<std::string, Entry> entries; // by file path
+
+public:
+    explicit Checkpoint(const std::string& path) : path(path) {}
+
+    // Reads the checkpoint file; returns false (and starts empty) when it is
+    // missing, malformed or was written for a different keyword list
+    bool load(const std::vector<std::string>& keywords);
+
+    // Writes to a temporary file and renames it over the old checkpoint, so
+    // an interrupted run never leaves a torn file behind
+    bool save(const std::vector<std::string>& keywords) const;
+
+    // Brings the analyzer's keyword totals up to date for files, scanning
+    // only what changed since the checkpoint, and records the new state
+    Stats update(LogAnalyzer& analyzer, const std::vector<LogFile>& files, WorkStealingPool& pool);
+};
+
+#endif
@@ -0,0 +1,203 @@
+#include "CompressedInput.h"
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+bool endsWith(const std::string& s, const char* suffix) {
+    std::string tail(suffix);
+    return s.size() >= tail.size() && s.compare(s.size() - tail.size(), tail.size(), tail) == 0;
+}
+
+#ifdef HAVE_ZLIB
+class GzipDecoder : public StreamDecoder {
+private:
+    gzFile file;
+    bool error = false;
+
+public:
+    explicit GzipDecoder(gzFile file) : file(file) {
+        gzbuffer(file, 256 * 1024);
+    }
+    ~GzipDecoder() override { gzclose(file); }
+
+    // gzread also walks concatenated gzip members
+    size_t read(std::string& out, size_t capacity) override {
+        size_t start = out.size();
+        out.resize(start + capacity);
+        size_t filled = 0;
+        while (filled < capacity && !error) {
+            unsigned want = static_cast<unsigned>(std::min<size_t>(capacity - filled, INT_MAX));
+            int got = gzread(file, &out[start + filled], want);
+            if (got < 0) error = true;
+            if (got <= 0) break;
+            filled += static_cast<size_t>(got);
+        }
+        out.resize(start + filled);
+        return filled;
+    }
+
+    bool failed() const override { return error; }
+};
+#endif
+
+#ifdef HAVE_ZSTD
+class ZstdDecoder : public StreamDecoder {
+private:
+    std::FILE* file;
+    ZSTD_DStream* stream;
+    std::vector<char> input;
+    ZSTD_inBuffer in{nullptr, 0, 0};
+    bool error = false;
+    bool eof = false;
+
+public:
+    ZstdDecoder(std::FILE* file, ZSTD_DStream* stream)
+        : file(file), stream(stream), input(ZSTD_DStreamInSize()) {
+        in.src = input.data();
+    }
+    ~ZstdDecoder() override {
+        ZSTD_freeDStream(stream);
+        std::fclose(file);
+    }
+
+    size_t read(std::string& out, size_t capacity) override {
+        size_t start = out.size();
+        out.resize(start + capacity);
+        ZSTD_outBuffer dst{&out[start], capacity, 0};
+        while (dst.pos < dst.size && !error) {
+            if (in.pos == in.size) {
+                if (eof) break;
+                in.size = std::fread(input.data(), 1, input.size(), file);
+                in.pos = 0;
+                if (in.size == 0) {
+                    eof = true;
+                    continue; // flush what the decoder still holds
+                }
+            }
+            size_t before = dst.pos;
+            size_t ret = ZSTD_decompressStream(stream, &dst, &in);
+            if (ZSTD_isError(ret)) error = true;
+            else if (eof && dst.pos == before) break;
+        }
+        out.resize(start + dst.pos);
+        return dst.pos;
+    }
+
+    bool failed() const override { return error; }
+};
+#endif
+}
+
+Compression compressionOf(const std::string& path) {
+    if (endsWith(path, ".log.gz")) return Compression::GZIP;
+    if (endsWith(path, ".log.zst")) return Compression::ZSTD;
+    return Compression::NONE;
+}
+
+bool isLogPath(const std::string& path) {
+    return endsWith(path, ".log") || compressionOf(path) != Compression::NONE;
+}
+
+bool compressionSupported(Compression compression) {
+    switch (compression) {
+    case Compression::NONE:
+        return true;
+    case Compression::GZIP:
+#ifdef HAVE_ZLIB
+        return true;
+#else
+        return false;
+#endif
+    case Compression::ZSTD:
+#ifdef HAVE_ZSTD
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+std::unique_ptr<StreamDecoder> StreamDecoder::open(const std::string& path, Compression compression) {
+#ifdef HAVE_ZLIB
+    if (compression == Compression::GZIP) {
+        gzFile file = gzopen(path.c_str(), "rb");
+        if (file) return std::make_unique<GzipDecoder>(file);
+    }
+#endif
+#ifdef HAVE_ZSTD
+    if (compression == Compression::ZSTD) {
+        std::FILE* file = std::fopen(path.c_str(), "rb");
+        if (!file) return nullptr;
+        ZSTD_DStream* stream = ZSTD_createDStream();
+        if (stream && !ZSTD_isError(ZSTD_initDStream(stream)))
+            return std::make_unique<ZstdDecoder>(file, stream);
+        if (stream) ZSTD_freeDStream(stream);
+        std::fclose(file);
+    }
+#endif
+    (void)path;
+    (void)compression;
+    return nullptr;
+}
+
+std::vector<std::pair<size_t, size_t>> zstdFrames(const char* data, size_t size) {
+    std::vector<std::pair<size_t, size_t>> frames;
+#ifdef HAVE_ZSTD
+    size_t pos = 0;
+    while (pos < size) {
+        size_t frameSize = ZSTD_findFrameCompressedSize(data + pos, size - pos);
+        if (ZSTD_isError(frameSize) || frameSize == 0) return {};
+        frames.emplace_back(pos, frameSize);
+        pos += frameSize;
+    }
+#else
+    (void)data;
+    (void)size;
+#endif
+    return frames;
+}
+
+bool zstdDecompressFrame(const char* data, size_t size, std::string& out) {
+#ifdef HAVE_ZSTD
+    // One context per thread, reused across frames
+    struct ContextDeleter {
+        void operator()(ZSTD_DCtx* ctx) const { ZSTD_freeDCtx(ctx); }
+    };
+    thread_local std::unique_ptr<ZSTD_DCtx, ContextDeleter> ctx(ZSTD_createDCtx());
+    if (!ctx) return false;
+    ZSTD_DCtx_reset(ctx.get(), ZSTD_reset_session_only);
+
+    // Skippable frames decompress to nothing; unknown sizes grow as needed
+    unsigned long long contentSize = ZSTD_getFrameContentSize(data, size);
+    if (contentSize == ZSTD_CONTENTSIZE_ERROR) return false;
+    size_t step = contentSize == ZSTD_CONTENTSIZE_UNKNOWN ? ZSTD_DStreamOutSize() : static_cast<size_t>(contentSize);
+
+    out.clear();
+    ZSTD_inBuffer in{data, size, 0};
+    while (true) {
+        size_t start = out.size();
+        out.resize(start + std::max<size_t>(step, 1));
+        ZSTD_outBuffer dst{&out[start], out.size() - start, 0};
+        size_t ret = ZSTD_decompressStream(ctx.get(), &dst, &in);
+        out.resize(start + dst.pos);
+        if (ZSTD_isError(ret)) return false;
+        if (ret == 0) return true;                           // frame complete
+        if (in.pos == in.size && dst.pos < dst.size) return false; // truncated
+        step = ZSTD_DStreamOutSize();
+    }
+#else
+    (void)data;
+    (void)size;
+    (void)out;
+    return false;
+#endif
+}
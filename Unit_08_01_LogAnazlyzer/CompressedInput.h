@@ -0,0 +1,44 @@
+#ifndef COMPRESSED_INPUT_H
+#define COMPRESSED_INPUT_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Rotated logs arrive as .log.gz or .log.zst. gzip support needs zlib
+// (-DHAVE_ZLIB -lz) and zstd support libzstd (-DHAVE_ZSTD -lzstd); without
+// them those files are reported and skipped.
+enum class Compression { NONE, GZIP, ZSTD };
+
+// Picks the format from the name: .log, .log.gz or .log.zst
+Compression compressionOf(const std::string& path);
+bool isLogPath(const std::string& path);
+bool compressionSupported(Compression compression);
+
+// Decompresses one file as a stream, block by block, so a file never has to
+// be inflated whole
+class StreamDecoder {
+public:
+    virtual ~StreamDecoder() = default;
+
+    // Appends up to capacity decompressed bytes to out; returns how many were
+    // appended, 0 at the end of the stream or on error
+    virtual size_t read(std::string& out, size_t capacity) = 0;
+    virtual bool failed() const = 0;
+
+    // nullptr when the file cannot be opened or the format is not built in
+    static std::unique_ptr<StreamDecoder> open(const std::string& path, Compression compression);
+};
+
+// zstd files made of several frames (pzstd, zstd --patch-from, concatenated
+// files) can be decompressed frame by frame in parallel. Returns the
+// (offset, size) of every frame, or nothing when the data is not zstd or was
+// built without it.
+std::vector<std::pair<size_t, size_t>> zstdFrames(const char* data, size_t size);
+
+// Decompresses one complete zstd frame into out
+bool zstdDecompressFrame(const char* data, size_t size, std::string& out);
+
+#endif
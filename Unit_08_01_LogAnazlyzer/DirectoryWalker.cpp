@@ -0,0 +1,194 @@
+#include "DirectoryWalker.h"
+#include "CompressedInput.h"
+#include "WorkStealingPool.h"
+#include <filesystem>
+#include <iostream>
+
+#ifdef __linux__
+#include <cstddef>
+#include <cstdint>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+bool classMatch(std::string_view pattern, size_t& p, char c) {
+    // pattern[p] is '['; on return p is past the closing ']'
+    size_t i = p + 1;
+    bool negate = i < pattern.size() && (pattern[i] == '!' || pattern[i] == '^');
+    if (negate) i++;
+    bool hit = false;
+    bool first = true;
+    while (i < pattern.size() && (first || pattern[i] != ']')) {
+        first = false;
+        char lo = pattern[i];
+        if (i + 2 < pattern.size() && pattern[i + 1] == '-' && pattern[i + 2] != ']') {
+            hit = hit || (c >= lo && c <= pattern[i + 2]);
+            i += 3;
+        } else {
+            hit = hit || c == lo;
+            i++;
+        }
+    }
+    p = i + 1;
+    return hit != negate;
+}
+
+#ifdef __linux__
+// Layout of the records getdents64 fills in
+struct LinuxDirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+};
+#endif
+}
+
+bool globMatch(std::string_view pattern, std::string_view text) {
+    size_t p = 0, t = 0;
+    // Backtracking point for the last single '*'
+    size_t starP = std::string_view::npos, starT = 0;
+    while (t < text.size()) {
+        if (p < pattern.size()) {
+            char pc = pattern[p];
+            if (pc == '*' && p + 1 < pattern.size() && pattern[p + 1] == '*') {
+                // "**" (and "**/") matches any run of components; after
+                // "**/" the rest must start a component, so "**/debug-*"
+                // does not match "nodebug-x"
+                size_t rest = p + 2;
+                bool componentStart = rest < pattern.size() && pattern[rest] == '/';
+                if (componentStart) rest++;
+                for (size_t k = t; k <= text.size(); ++k) {
+                    if (componentStart && k != t && text[k - 1] != '/') continue;
+                    if (globMatch(pattern.substr(rest), text.substr(k))) return true;
+                }
+                return false;
+            }
+            if (pc == '*') {
+                starP = p++;
+                starT = t;
+                continue;
+            }
+            if (pc == '?' && text[t] != '/') {
+                p++;
+                t++;
+                continue;
+            }
+            if (pc == '[' && text[t] != '/') {
+                size_t next = p;
+                if (classMatch(pattern, next, text[t])) {
+                    p = next;
+                    t++;
+                    continue;
+                }
+            } else if (pc == text[t]) {
+                p++;
+                t++;
+                continue;
+            }
+        }
+        // Let the last '*' take one more character, never a '/'
+        if (starP == std::string_view::npos || text[starT] == '/') return false;
+        p = starP + 1;
+        t = ++starT;
+    }
+    while (p < pattern.size() && pattern[p] == '*') p++;
+    return p == pattern.size();
+}
+
+bool DirectoryWalker::matchesAny(const std::vector<std::string>& globs, std::string_view relative,
+                                 std::string_view name) const {
+    for (const auto& g : globs) {
+        bool byPath = g.find('/') != std::string::npos;
+        if (globMatch(g, byPath ? relative : name)) return true;
+    }
+    return false;
+}
+
+bool DirectoryWalker::excluded(std::string_view relative, std::string_view name) const {
+    return matchesAny(options.exclude, relative, name);
+}
+
+bool DirectoryWalker::wanted(std::string_view relative, std::string_view name) const {
+    if (excluded(relative, name)) return false;
+    if (options.include.empty()) return isLogPath(std::string(name));
+    return matchesAny(options.include, relative, name);
+}
+
+void DirectoryWalker::walk(const std::string& root, WorkStealingPool& pool, const FileSink& onFile) {
+    sink = onFile;
+    pool.submit([this, root, &pool]() { listDirectory(root, "", pool); });
+}
+
+void DirectoryWalker::listDirectory(const std::string& path, const std::string& relative, WorkStealingPool& pool) {
+    directoryCount++;
+    auto childRelative = [&](const std::string& name) { return relative.empty() ? name : relative + "/" + name; };
+    auto childPath = [&](const std::string& name) { return path + "/" + name; };
+
+    auto onEntry = [&](const std::string& name, bool isDir, bool isFile, unsigned long long size) {
+        std::string rel = childRelative(name);
+        if (isDir) {
+            if (options.recursive && !excluded(rel, name))
+                pool.submit([this, p = childPath(name), rel, &pool]() { listDirectory(p, rel, pool); });
+        } else if (isFile && wanted(rel, name)) {
+            fileCount++;
+            sink(LogFile{childPath(name), size});
+        }
+    };
+
+#ifdef __linux__
+    int fd = ::open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "Error: Could not open directory " << path << "\n";
+        return;
+    }
+    alignas(LinuxDirent64) char buf[64 * 1024];
+    long n;
+    while ((n = syscall(SYS_getdents64, fd, buf, sizeof(buf))) > 0) {
+        for (long pos = 0; pos < n;) {
+            const LinuxDirent64* d = reinterpret_cast<const LinuxDirent64*>(buf + pos);
+            pos += d->d_reclen;
+            const char* name = reinterpret_cast<const char*>(d) + offsetof(LinuxDirent64, d_name);
+            if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) continue;
+
+            // Directories are never followed through symlinks, which rules out cycles
+            bool isDir = d->d_type == DT_DIR;
+            bool isFile = d->d_type == DT_REG;
+            bool needStat = d->d_type == DT_UNKNOWN || d->d_type == DT_LNK;
+            if (!isDir && !isFile && !needStat) continue;
+
+            std::string entryName(name);
+            unsigned long long size = 0;
+            if (isFile || needStat) {
+                // Only names that could be wanted are worth the fstatat
+                if (!needStat && !wanted(childRelative(entryName), entryName)) continue;
+                struct stat st;
+                int flags = d->d_type == DT_UNKNOWN ? AT_SYMLINK_NOFOLLOW : 0;
+                if (fstatat(fd, name, &st, flags) != 0) continue;
+                isDir = d->d_type == DT_UNKNOWN && S_ISDIR(st.st_mode);
+                isFile = S_ISREG(st.st_mode);
+                size = static_cast<unsigned long long>(st.st_size);
+            }
+            onEntry(entryName, isDir, isFile, size);
+        }
+    }
+    if (n < 0) std::cerr << "Error: Could not read directory " << path << "\n";
+    ::close(fd);
+#else
+    std::error_code ec;
+    for (fs::directory_iterator it(path, ec), end; !ec && it != end; it.increment(ec)) {
+        std::string name = it->path().filename().string();
+        bool isDir = it->is_directory(ec) && !it->is_symlink(ec);
+        bool isFile = !isDir && it->is_regular_file(ec);
+        onEntry(name, isDir, isFile, isFile ? it->file_size(ec) : 0);
+    }
+    if (ec) std::cerr << "Error: Could not read directory " << path << "\n";
+#endif
+}
@@ -0,0 +1,55 @@
+#ifndef DIRECTORY_WALKER_H
+#define DIRECTORY_WALKER_H
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "LogAnalyzer.h"
+
+class WorkStealingPool;
+
+// Which files a walk hands out. Globs without a '/' match the file or
+// directory name, globs with one match the path relative to the root.
+// "*" and "?" stay within one path component, "**" crosses them, and
+// "[...]" is a character class.
+struct WalkOptions {
+    std::vector<std::string> include; // files to scan; default *.log, *.log.gz, *.log.zst
+    std::vector<std::string> exclude; // files and whole subtrees to skip
+    bool recursive = true;
+};
+
+bool globMatch(std::string_view pattern, std::string_view text);
+
+// Lists a directory tree in parallel: every directory is a pool task that
+// reads its entries in large batches (getdents64 on Linux, so a wide
+// directory costs a few system calls, with types taken from the entries
+// and sizes from fstatat on the open directory) and submits a task per
+// subdirectory. Files go to the sink as soon as their directory is read.
+class DirectoryWalker {
+private:
+    WalkOptions options;
+    FileSink sink;
+    std::atomic<size_t> fileCount{0};
+    std::atomic<size_t> directoryCount{0};
+
+    bool matchesAny(const std::vector<std::string>& globs, std::string_view relative, std::string_view name) const;
+    bool wanted(std::string_view relative, std::string_view name) const;
+    bool excluded(std::string_view relative, std::string_view name) const;
+
+    // Lists one directory; relative is its path below the root ("" for the root)
+    void listDirectory(const std::string& path, const std::string& relative, WorkStealingPool& pool);
+
+public:
+    explicit DirectoryWalker(const WalkOptions& options) : options(options) {}
+
+    // Starts the walk and returns; the sink is called from pool workers until
+    // the pool is idle again
+    void walk(const std::string& root, WorkStealingPool& pool, const FileSink& onFile);
+
+    size_t filesFound() const { return fileCount; }
+    size_t directoriesListed() const { return directoryCount; }
+};
+
+#endif
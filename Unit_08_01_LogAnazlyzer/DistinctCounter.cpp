@@ -0,0 +1,145 @@
+#include "DistinctCounter.h"
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace {
+// Start of the width-second bucket holding t, rounding down for negative t
+int64_t floorTo(int64_t t, int64_t width) {
+    int64_t q = t / width;
+    if (t % width != 0 && t < 0) q--;
+    return q * width;
+}
+
+// Next space-separated word at or after pos; empty at the end
+std::string_view nextWord(std::string_view text, size_t& pos) {
+    while (pos < text.size() && text[pos] == ' ') pos++;
+    size_t start = pos;
+    while (pos < text.size() && text[pos] != ' ') pos++;
+    return text.substr(start, pos - start);
+}
+}
+
+FieldExtractor FieldExtractor::parse(const std::string& spec) {
+    FieldExtractor field;
+    field.spec = spec;
+    if (spec == "detail") {
+        field.kind = DETAIL;
+    } else if (spec == "last") {
+        field.kind = LAST_WORD;
+    } else if (spec.compare(0, 5, "word:") == 0 && std::atoi(spec.c_str() + 5) > 0) {
+        field.kind = WORD;
+        field.word = static_cast<size_t>(std::atoi(spec.c_str() + 5));
+    } else if (spec.compare(0, 4, "key:") == 0 && spec.size() > 4) {
+        field.kind = KEY;
+        field.key = spec.substr(4) + "=";
+    } else {
+        throw std::invalid_argument("Unknown field \"" + spec + "\" (use detail, last, word:N or key:NAME)");
+    }
+    return field;
+}
+
+std::string_view FieldExtractor::extract(const ParsedLine& line) const {
+    switch (kind) {
+    case DETAIL:
+        return line.detail;
+    case LAST_WORD: {
+        size_t space = line.message.rfind(' ');
+        return space == std::string_view::npos ? line.message : line.message.substr(space + 1);
+    }
+    case WORD: {
+        size_t pos = 0;
+        std::string_view w;
+        for (size_t i = 0; i < word; ++i) {
+            w = nextWord(line.detail, pos);
+            if (w.empty()) break;
+        }
+        return w;
+    }
+    case KEY: {
+        size_t pos = 0;
+        while (true) {
+            std::string_view w = nextWord(line.message, pos);
+            if (w.empty()) return w;
+            if (w.size() > key.size() && w.compare(0, key.size(), key) == 0) return w.substr(key.size());
+        }
+    }
+    }
+    return std::string_view();
+}
+
+DistinctCounter::DistinctCounter(int64_t bucketWidth) : width(bucketWidth) {}
+
+DistinctCounter::Bucket& DistinctCounter::bucketFor(int64_t start) {
+    if (lastBucket < buckets.size() && buckets[lastBucket].start == start)
+        return buckets[lastBucket];
+
+    auto it = bucketIndex.find(start);
+    if (it != bucketIndex.end()) {
+        lastBucket = it->second;
+    } else {
+        lastBucket = buckets.size();
+        buckets.push_back(Bucket{start, {}});
+        bucketIndex.emplace(start, lastBucket);
+    }
+    return buckets[lastBucket];
+}
+
+void DistinctCounter::add(const ParsedLine& line, uint64_t valueHash) {
+    bucketFor(floorTo(line.epoch, width)).levels[static_cast<int>(line.level)].add(valueHash);
+}
+
+void DistinctCounter::merge(const DistinctCounter& other) {
+    for (const auto& bucket : other.buckets) {
+        Bucket& mine = bucketFor(bucket.start);
+        for (int l = 0; l < LOG_LEVEL_COUNT; ++l)
+            mine.levels[l].merge(bucket.levels[l]);
+    }
+}
+
+size_t DistinctCounter::counters() const {
+    size_t n = 0;
+    for (const auto& bucket : buckets)
+        for (const auto& hll : bucket.levels)
+            if (!hll.empty()) n++;
+    return n;
+}
+
+std::vector<const DistinctCounter::Bucket*> DistinctCounter::inRange(int64_t from, int64_t to) const {
+    std::vector<const Bucket*> selected;
+    for (const auto& bucket : buckets) {
+        bool beforeEnd = bucket.start < to;
+        bool afterStart = bucket.start >= from || from - bucket.start < width;
+        if (beforeEnd && afterStart) selected.push_back(&bucket);
+    }
+    std::sort(selected.begin(), selected.end(), [](const Bucket* a, const Bucket* b) { return a->start < b->start; });
+    return selected;
+}
+
+DistinctCounter::Row DistinctCounter::estimate(int64_t start, const std::array<HyperLogLog, LOG_LEVEL_COUNT>& levels) {
+    Row row;
+    row.start = start;
+    HyperLogLog all;
+    for (int l = 0; l < LOG_LEVEL_COUNT; ++l) {
+        row.levels[l] = levels[l].estimate();
+        all.merge(levels[l]);
+    }
+    row.total = all.estimate();
+    return row;
+}
+
+std::vector<DistinctCounter::Row> DistinctCounter::rows(int64_t from, int64_t to) const {
+    std::vector<Row> result;
+    for (const Bucket* bucket : inRange(from, to))
+        result.push_back(estimate(bucket->start, bucket->levels));
+    return result;
+}
+
+DistinctCounter::Row DistinctCounter::total(int64_t from, int64_t to) const {
+    std::vector<const Bucket*> selected = inRange(from, to);
+    std::array<HyperLogLog, LOG_LEVEL_COUNT> levels;
+    for (const Bucket* bucket : selected)
+        for (int l = 0; l < LOG_LEVEL_COUNT; ++l)
+            levels[l].merge(bucket->levels[l]);
+    return estimate(selected.empty() ? from : selected.front()->start, levels);
+}
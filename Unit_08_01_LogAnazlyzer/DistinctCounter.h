@@ -0,0 +1,83 @@
+#ifndef DISTINCT_COUNTER_H
+#define DISTINCT_COUNTER_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "HyperLogLog.h"
+#include "LogParser.h"
+#include "TimeHistogram.h"
+
+// Picks the value to count distinct occurrences of from a parsed line:
+//   detail    text after the " — " separator
+//   last      last word of the message
+//   word:N    Nth word (from 1) of the detail
+//   key:NAME  value of a NAME=value word in the message
+// Lines without the field are not counted.
+class FieldExtractor {
+public:
+    enum Kind { DETAIL, LAST_WORD, WORD, KEY };
+
+private:
+    Kind kind = DETAIL;
+    size_t word = 0;  // WORD: 1-based position
+    std::string key;  // KEY: "NAME="
+    std::string spec;
+
+public:
+    // Throws std::invalid_argument for an unknown spec
+    static FieldExtractor parse(const std::string& spec);
+
+    std::string_view extract(const ParsedLine& line) const;
+    const std::string& name() const { return spec; }
+};
+
+// One HyperLogLog per time bucket and level. Counts for a range or across
+// levels are the union (register-wise max) of the bucket counters, so
+// "distinct values at FATAL today" needs no second pass.
+class DistinctCounter {
+public:
+    // Estimated distinct values per level and over all levels
+    struct Row {
+        int64_t start;
+        std::array<double, LOG_LEVEL_COUNT> levels{};
+        double total = 0;
+    };
+
+private:
+    struct Bucket {
+        int64_t start;
+        std::array<HyperLogLog, LOG_LEVEL_COUNT> levels;
+    };
+
+    int64_t width;
+    std::vector<Bucket> buckets; // arrival order
+    std::unordered_map<int64_t, size_t> bucketIndex;
+    size_t lastBucket = 0; // log lines arrive mostly in time order
+
+    Bucket& bucketFor(int64_t start);
+    // Buckets overlapping [from, to), in time order
+    std::vector<const Bucket*> inRange(int64_t from, int64_t to) const;
+    static Row estimate(int64_t start, const std::array<HyperLogLog, LOG_LEVEL_COUNT>& levels);
+
+public:
+    explicit DistinctCounter(int64_t bucketWidth = TimeHistogram::HOUR);
+
+    void add(const ParsedLine& line, uint64_t valueHash);
+    // Adds another (per-worker) counter with the same bucket width
+    void merge(const DistinctCounter& other);
+
+    int64_t bucketWidth() const { return width; }
+    // Number of HyperLogLogs holding data, each HyperLogLog::REGISTERS bytes
+    size_t counters() const;
+
+    // One row per bucket overlapping [from, to) that has values, in time order
+    std::vector<Row> rows(int64_t from = TimeHistogram::MIN_TIME, int64_t to = TimeHistogram::MAX_TIME) const;
+    // Distinct values over the whole range; start is the first bucket's
+    Row total(int64_t from = TimeHistogram::MIN_TIME, int64_t to = TimeHistogram::MAX_TIME) const;
+};
+
+#endif
@@ -0,0 +1,60 @@
+#include "HyperLogLog.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+uint64_t HyperLogLog::hash(std::string_view value) {
+    // std::hash may be weak in its low bits; the splitmix64 finalizer spreads
+    // every input bit over the register index and the zero run
+    uint64_t h = std::hash<std::string_view>{}(value);
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBULL;
+    h ^= h >> 31;
+    return h;
+}
+
+void HyperLogLog::add(uint64_t hash) {
+    if (registers.empty()) registers.assign(REGISTERS, 0);
+    size_t index = static_cast<size_t>(hash >> (64 - PRECISION));
+    uint64_t rest = hash << PRECISION;
+
+    // Position of the first 1 bit in the remaining 64 - PRECISION bits
+    uint8_t rank = 1;
+#if defined(__GNUC__)
+    rank = rest == 0 ? 64 - PRECISION + 1 : static_cast<uint8_t>(__builtin_clzll(rest) + 1);
+#else
+    while (rank <= 64 - PRECISION && !(rest & (uint64_t(1) << 63))) {
+        rest <<= 1;
+        rank++;
+    }
+#endif
+    if (rank > registers[index]) registers[index] = rank;
+}
+
+void HyperLogLog::merge(const HyperLogLog& other) {
+    if (other.registers.empty()) return;
+    if (registers.empty()) {
+        registers = other.registers;
+        return;
+    }
+    for (size_t i = 0; i < REGISTERS; ++i)
+        registers[i] = std::max(registers[i], other.registers[i]);
+}
+
+double HyperLogLog::estimate() const {
+    if (registers.empty()) return 0;
+    const double m = static_cast<double>(REGISTERS);
+    double sum = 0;
+    size_t zeros = 0;
+    for (uint8_t r : registers) {
+        sum += std::ldexp(1.0, -r);
+        if (r == 0) zeros++;
+    }
+    double raw = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+    // Small cardinalities: linear counting over the empty registers is
+    // more accurate than the harmonic mean
+    if (raw <= 2.5 * m && zeros > 0) return m * std::log(m / zeros);
+    return raw;
+}
@@ -0,0 +1,33 @@
+#ifndef HYPER_LOG_LOG_H
+#define HYPER_LOG_LOG_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Approximate count of distinct values in 4 KB: 2^12 one-byte registers,
+// each holding the longest run of leading zero bits seen among the hashes
+// routed to it. The standard error is about 1.6%. Two counters merge by
+// taking the larger register, so per-worker and per-bucket counters can be
+// combined into the count of their union.
+class HyperLogLog {
+public:
+    static const int PRECISION = 12;
+    static const size_t REGISTERS = size_t(1) << PRECISION;
+
+private:
+    // Allocated on the first add, so unused counters cost nothing
+    std::vector<uint8_t> registers;
+
+public:
+    // 64-bit hash of a value, for add()
+    static uint64_t hash(std::string_view value);
+
+    void add(uint64_t hash);
+    void merge(const HyperLogLog& other);
+
+    bool empty() const { return registers.empty(); }
+    double estimate() const;
+};
+
+#endif
@@ -0,0 +1,178 @@
+#include "KeywordMatcher.h"
+#include <algorithm>
+#include <cstring>
+#include <queue>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+KeywordMatcher::KeywordMatcher(const std::vector<std::string>& keywordList) : keywords(keywordList) {
+    // Give every byte used by a keyword its own column; all other bytes share column 0
+    byteClass.assign(256, 0);
+    for (const auto& k : keywords)
+        for (unsigned char c : k)
+            if (byteClass[c] == 0) byteClass[c] = static_cast<uint8_t>(classCount++);
+
+    // Build the trie (goto function); -1 marks a missing edge
+    std::vector<std::vector<int32_t>> ownOutputs(1);
+    transitions.assign(classCount, -1);
+    for (size_t id = 0; id < keywords.size(); ++id) {
+        int32_t state = 0;
+        for (unsigned char c : keywords[id]) {
+            int32_t& next = transitions[state * classCount + byteClass[c]];
+            if (next < 0) {
+                next = static_cast<int32_t>(ownOutputs.size());
+                ownOutputs.emplace_back();
+                transitions.resize(transitions.size() + classCount, -1);
+            }
+            state = transitions[state * classCount + byteClass[c]];
+        }
+        if (!keywords[id].empty()) ownOutputs[state].push_back(static_cast<int32_t>(id));
+    }
+    const size_t stateCount = ownOutputs.size();
+
+    // Breadth-first pass: compute failure links, turn the trie into a full DFA
+    // and link every state to the nearest suffix state that reports a match
+    std::vector<int32_t> fail(stateCount, 0);
+    outputLink.assign(stateCount, -1);
+    std::queue<int32_t> pending;
+    for (int c = 0; c < classCount; ++c) {
+        int32_t& next = transitions[c];
+        if (next < 0) {
+            next = 0;
+        } else {
+            pending.push(next);
+        }
+    }
+    while (!pending.empty()) {
+        int32_t state = pending.front();
+        pending.pop();
+        int32_t f = fail[state];
+        outputLink[state] = ownOutputs[f].empty() ? outputLink[f] : f;
+        for (int c = 0; c < classCount; ++c) {
+            int32_t& next = transitions[state * classCount + c];
+            if (next < 0) {
+                next = transitions[f * classCount + c];
+            } else {
+                fail[next] = transitions[f * classCount + c];
+                pending.push(next);
+            }
+        }
+    }
+
+    // Flatten per-state outputs
+    outputStart.resize(stateCount);
+    outputCount.resize(stateCount);
+    for (size_t s = 0; s < stateCount; ++s) {
+        outputStart[s] = static_cast<int32_t>(outputIds.size());
+        outputCount[s] = static_cast<int32_t>(ownOutputs[s].size());
+        outputIds.insert(outputIds.end(), ownOutputs[s].begin(), ownOutputs[s].end());
+    }
+
+    // Prefilter set: first bytes of all keywords, and newline so line counting stays exact
+    startByte[static_cast<unsigned char>('\n')] = true;
+    for (const auto& k : keywords)
+        if (!k.empty()) startByte[static_cast<unsigned char>(k[0])] = true;
+    for (int c = 0; c < 256; ++c)
+        if (startByte[c]) startBytes.push_back(static_cast<uint8_t>(c));
+}
+
+// Returns the first position at or after p holding a byte from the prefilter set
+const char* KeywordMatcher::skipToCandidate(const char* p, const char* end) const {
+#if defined(__AVX2__)
+    // Same as the SSE2 loop below, 32 bytes at a time (build with -mavx2 or -march=native)
+    if (startBytes.size() <= 8) {
+        __m256i needles[8];
+        const size_t n = startBytes.size();
+        for (size_t i = 0; i < n; ++i)
+            needles[i] = _mm256_set1_epi8(static_cast<char>(startBytes[i]));
+        while (end - p >= 32) {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            __m256i hit = _mm256_cmpeq_epi8(block, needles[0]);
+            for (size_t i = 1; i < n; ++i)
+                hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(block, needles[i]));
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hit));
+            if (mask != 0) return p + __builtin_ctz(mask);
+            p += 32;
+        }
+    }
+#elif defined(__SSE2__)
+    // Compare 16 bytes at a time against each start byte; worth it while the
+    // set is small (e.g. every level keyword starts with '[')
+    if (startBytes.size() <= 8) {
+        __m128i needles[8];
+        const size_t n = startBytes.size();
+        for (size_t i = 0; i < n; ++i)
+            needles[i] = _mm_set1_epi8(static_cast<char>(startBytes[i]));
+        while (end - p >= 16) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            __m128i hit = _mm_cmpeq_epi8(block, needles[0]);
+            for (size_t i = 1; i < n; ++i)
+                hit = _mm_or_si128(hit, _mm_cmpeq_epi8(block, needles[i]));
+            int mask = _mm_movemask_epi8(hit);
+            if (mask != 0) return p + __builtin_ctz(static_cast<unsigned>(mask));
+            p += 16;
+        }
+    }
+#endif
+    while (p < end && !startByte[static_cast<unsigned char>(*p)]) ++p;
+    return p;
+}
+
+// Runs the automaton over [begin, end) and calls onMatch(keywordId, lineNumber)
+// for every keyword occurrence; lines are numbered from 0 within the buffer
+template <typename OnMatch>
+uint64_t KeywordMatcher::scan(const char* begin, const char* end, OnMatch onMatch) const {
+    const int32_t* table = transitions.data();
+    const uint8_t* classes = byteClass.data();
+    uint64_t line = 0;
+    int32_t state = 0;
+    const char* p = begin;
+
+    while (p < end) {
+        if (state == 0) {
+            p = skipToCandidate(p, end);
+            if (p == end) break;
+        }
+        unsigned char c = static_cast<unsigned char>(*p++);
+        if (c == '\n') {
+            // Keywords never span lines
+            line++;
+            state = 0;
+            continue;
+        }
+        state = table[state * classCount + classes[c]];
+        for (int32_t s = outputCount[state] ? state : outputLink[state]; s > 0; s = outputLink[s]) {
+            for (int32_t i = 0; i < outputCount[s]; ++i)
+                onMatch(outputIds[outputStart[s] + i], line);
+        }
+    }
+    return line;
+}
+
+uint64_t KeywordMatcher::countLines(const char* begin, const char* end, std::vector<long long>& counts) const {
+    // Remember the last line each keyword was counted on so that a keyword
+    // occurring twice in a line is counted once, like the original find() loop.
+    // The vector is per thread so a call does not allocate once warmed up.
+    thread_local std::vector<uint64_t> lastLine;
+    lastLine.assign(keywords.size(), UINT64_MAX);
+    uint64_t newlines = scan(begin, end, [&](int32_t id, uint64_t line) {
+        if (lastLine[id] != line) {
+            lastLine[id] = line;
+            counts[id]++;
+        }
+    });
+    // A last line without a newline still counts
+    return newlines + (begin < end && end[-1] != '\n' ? 1 : 0);
+}
+
+void KeywordMatcher::findInLine(const char* begin, const char* end, std::vector<int>& hits) const {
+    hits.clear();
+    scan(begin, end, [&](int32_t id, uint64_t) {
+        if (std::find(hits.begin(), hits.end(), id) == hits.end())
+            hits.push_back(id);
+    });
+}
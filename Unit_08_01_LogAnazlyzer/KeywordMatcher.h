@@ -0,0 +1,47 @@
+#ifndef KEYWORD_MATCHER_H
+#define KEYWORD_MATCHER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Aho-Corasick automaton compiled once from a keyword list. A buffer is
+// scanned in a single pass whatever the number of keywords; while the
+// automaton sits in its start state, a prefilter (SSE2, or AVX2 when built for it) skips
+// ahead to the next byte that can begin a keyword or end a line.
+// Keyword IDs are the indices into the vector given to the constructor.
+class KeywordMatcher {
+private:
+    std::vector<std::string> keywords;
+    std::vector<uint8_t> byteClass;     // byte -> column in the transition table
+    int classCount = 1;                 // class 0 = bytes that appear in no keyword
+    std::vector<int32_t> transitions;   // state * classCount + class -> next state
+    std::vector<int32_t> outputStart;   // per state, first entry in outputIds
+    std::vector<int32_t> outputCount;   // per state, keywords ending exactly here
+    std::vector<int32_t> outputLink;    // per state, nearest suffix state with output (-1 if none)
+    std::vector<int32_t> outputIds;
+    bool startByte[256] = {};           // bytes that can begin a keyword, plus '\n'
+    std::vector<uint8_t> startBytes;    // the same set as a list, for the SIMD prefilter
+
+    const char* skipToCandidate(const char* p, const char* end) const;
+
+    // Returns the number of newlines in [begin, end)
+    template <typename OnMatch>
+    uint64_t scan(const char* begin, const char* end, OnMatch onMatch) const;
+
+public:
+    explicit KeywordMatcher(const std::vector<std::string>& keywordList);
+
+    size_t size() const { return keywords.size(); }
+    const std::string& keyword(size_t id) const { return keywords[id]; }
+
+    // Adds to counts[id] the number of lines in [begin, end) containing keyword id.
+    // counts must have size() entries. Returns the number of lines in the range.
+    uint64_t countLines(const char* begin, const char* end, std::vector<long long>& counts) const;
+
+    // Fills hits with the distinct IDs of keywords found in one line
+    void findInLine(const char* begin, const char* end, std::vector<int>& hits) const;
+};
+
+#endif
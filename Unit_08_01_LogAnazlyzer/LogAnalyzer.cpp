@@ -1,28 +1,424 @@
 #include "LogAnalyzer.h"
+#include "CompressedInput.h"
+#include "MappedFile.h"
+#include "WorkStealingPool.h"
 #include <fstream>
 #include <iostream>
 #include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <memory>
 
-// Function to analyze a single log file
-void LogAnalyzer::analyzeFile(const std::string& filename, const std::vector<std::string>& keywords) {
-    std::ifstream file(filename);
+LogAnalyzer::LogAnalyzer(const std::vector<std::string>& keywords)
+    : keywordNames(internKeywords(keywords)), matcher(keywordNames), keywordCounts(keywordNames.size(), 0) {}
+
+// Keeps the first occurrence of each keyword; its position becomes its ID
+std::vector<std::string> LogAnalyzer::internKeywords(const std::vector<std::string>& keywords) {
+    std::vector<std::string> unique;
+    for (const auto& k : keywords) {
+        if (std::find(unique.begin(), unique.end(), k) == unique.end())
+            unique.push_back(k);
+    }
+    return unique;
+}
+
+LogAnalyzer::WorkerState LogAnalyzer::newWorkerState() const {
+    WorkerState state;
+    state.counts.assign(keywordNames.size(), 0);
+    if (buildTemplates) state.templates = TopKSketch(templates.capacity());
+    if (buildDistinct) state.distinct = DistinctCounter(distinct.bucketWidth());
+    return state;
+}
+
+void LogAnalyzer::mergeState(const WorkerState& state) {
+    std::lock_guard<std::mutex> lock(countMutex);
+    for (size_t id = 0; id < state.counts.size(); ++id)
+        keywordCounts[id] += state.counts[id];
+    if (buildTable) table.merge(state.table);
+    if (buildHistogram) histogram.merge(state.histogram);
+    if (buildTemplates) templates.merge(state.templates);
+    if (buildDistinct) distinct.merge(state.distinct);
+    matchedLines += state.matchedLines;
+    linesScanned += state.lines;
+}
+
+void LogAnalyzer::mergeStates(const std::vector<WorkerState>& states) {
+    for (const auto& state : states)
+        mergeState(state);
+    std::lock_guard<std::mutex> lock(countMutex);
+    histogram.finalize();
+}
+
+void LogAnalyzer::parseLine(std::string_view line, WorkerState& state) const {
+    ParsedLine parsed;
+    if (!parseLogLine(line, parsed)) {
+        if (buildTable && !line.empty()) state.table.countUnparsed();
+        return;
+    }
+    if (buildTable) state.table.append(parsed);
+    if (buildHistogram) state.histogram.add(parsed);
+    if (buildTemplates) {
+        messageTemplate(parsed.messageType, state.templateText);
+        state.templates.add(state.templateText);
+    }
+    if (buildDistinct) {
+        std::string_view value = distinctField.extract(parsed);
+        if (!value.empty()) state.distinct.add(parsed, HyperLogLog::hash(value));
+    }
+}
+
+void LogAnalyzer::countMatch(std::string_view line, WorkerState& state) const {
+    state.matchedLines++;
+    matcher.findInLine(line.data(), line.data() + line.size(), state.hits);
+    for (int id : state.hits)
+        state.counts[id]++;
+    if (parsesLines()) parseLine(line, state);
+}
+
+void LogAnalyzer::scanMatching(const char* begin, const char* end, WorkerState& state) const {
+    std::string_view chunk(begin, end - begin);
+    const std::string& required = query->requiredText();
+    size_t pos = 0;
+    while (pos < chunk.size()) {
+        if (!required.empty()) {
+            // Jump to the line holding the next occurrence; the lines skipped
+            // cannot match and are never parsed
+            size_t hit = chunk.find(required, pos);
+            if (hit == std::string_view::npos) break;
+            size_t nl = chunk.rfind('\n', hit);
+            pos = (nl == std::string_view::npos || nl < pos) ? pos : nl + 1;
+        }
+        size_t nl = chunk.find('\n', pos);
+        size_t lineEnd = nl == std::string_view::npos ? chunk.size() : nl;
+        std::string_view line = chunk.substr(pos, lineEnd - pos);
+        if (query->matches(line)) countMatch(line, state);
+        pos = lineEnd + 1;
+    }
+}
+
+void LogAnalyzer::scanChunk(const char* begin, const char* end, WorkerState& state) const {
+    if (query) {
+        scanMatching(begin, end, state);
+        return;
+    }
+    state.lines += matcher.countLines(begin, end, state.counts);
+    if (!parsesLines()) return;
+
+    // One parse per line feeds every enabled report
+    const char* p = begin;
+    while (p < end) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        const char* lineEnd = nl ? nl : end;
+        parseLine(std::string_view(p, lineEnd - p), state);
+        p = lineEnd + 1;
+    }
+}
+
+namespace {
+// Moves everything after the last newline of block into carry
+void cutAtLastLine(std::string& block, std::string& carry) {
+    size_t nl = block.rfind('\n');
+    if (nl == std::string::npos) {
+        carry = std::move(block);
+        block.clear();
+    } else {
+        carry.assign(block, nl + 1, std::string::npos);
+        block.resize(nl + 1);
+    }
+}
+
+// A compressed file being decompressed by a chain of pool tasks
+struct DecodeJob {
+    std::unique_ptr<StreamDecoder> decoder;
+    std::string path;
+    std::string carry; // partial line at the end of the last block
+};
+
+// Frame-boundary fragments of a multi-frame zstd file: every frame task
+// scans its complete lines and leaves the text before its first and after
+// its last newline; the last task to finish joins them into lines
+struct FrameSeams {
+    std::vector<std::string> heads, tails;
+    std::vector<char> hasNewline;
+    std::atomic<size_t> remaining{0};
+};
+
+const char* missingLibrary(Compression compression) {
+    return compression == Compression::GZIP ? "zlib (-DHAVE_ZLIB)" : "libzstd (-DHAVE_ZSTD)";
+}
+}
+
+bool LogAnalyzer::scanCompressed(const std::string& filename, WorkerState& state, unsigned long long& bytes) const {
+    Compression compression = compressionOf(filename);
+    if (!compressionSupported(compression)) {
+        std::cerr << "Skipping " << filename << ": built without " << missingLibrary(compression) << "\n";
+        return false;
+    }
+    auto decoder = StreamDecoder::open(filename, compression);
+    if (!decoder) {
+        std::cerr << "Error: Could not open file " << filename << "\n";
+        return false;
+    }
+
+    std::string block, carry;
+    while (true) {
+        block.swap(carry);
+        size_t got = decoder->read(block, CHUNK_SIZE);
+        bytes += got;
+        if (got == 0) break;
+        cutAtLastLine(block, carry);
+        scanChunk(block.data(), block.data() + block.size(), state);
+    }
+    scanChunk(block.data(), block.data() + block.size(), state); // last line without a newline
+    if (decoder->failed()) {
+        std::cerr << "Error: Corrupt compressed file " << filename << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool LogAnalyzer::scanStream(const std::string& filename, WorkerState& state) const {
+    if (compressionOf(filename) != Compression::NONE) {
+        unsigned long long bytes = 0;
+        return scanCompressed(filename, state, bytes);
+    }
+
+    std::ifstream file(filename, std::ios::binary);
     if (!file) {
         std::cerr << "Error: Could not open file " << filename << "\n";
-        return;
+        return false;
+    }
+
+    // Lines are scanned as views into one reused buffer; only the partial
+    // line at the end of a block is moved to the front for the next read
+    std::vector<char>& buffer = state.readBuffer;
+    if (buffer.size() < STREAM_BLOCK) buffer.resize(STREAM_BLOCK);
+    size_t kept = 0;
+    while (true) {
+        if (kept == buffer.size()) buffer.resize(buffer.size() * 2); // one line longer than the buffer
+        file.read(buffer.data() + kept, static_cast<std::streamsize>(buffer.size() - kept));
+        size_t got = static_cast<size_t>(file.gcount());
+        if (got == 0) break;
+
+        const char* begin = buffer.data();
+        const char* end = begin + kept + got;
+        const char* cut = end;
+        while (cut > begin + kept && cut[-1] != '\n') --cut;
+        if (cut == begin + kept) { // no newline in this read
+            kept += got;
+            continue;
+        }
+        scanChunk(begin, cut, state);
+        kept = end - cut;
+        std::memmove(buffer.data(), cut, kept);
     }
+    scanChunk(buffer.data(), buffer.data() + kept, state); // last line without a newline
+    if (file.bad()) {
+        std::cerr << "Error: Could not read file " << filename << "\n";
+        return false;
+    }
+    return true;
+}
 
+// Function to analyze a single log file
+void LogAnalyzer::analyzeFile(const std::string& filename) {
     std::cout << "Processing: " << filename << std::endl;
-    std::string line;
-
-    while (std::getline(file, line)) {
-        for (const auto& keyword : keywords) {
-            if (line.find(keyword) != std::string::npos) {
-                // Thread-safe increment of keyword count
-                std::lock_guard<std::mutex> lock(countMutex);
-                keywordCounts[keyword]++;
+    WorkerState state = newWorkerState(); // this thread only, no locking
+    if (scanStream(filename, state))
+        mergeState(state);
+    histogram.finalize();
+}
+
+// Function to analyze many files as tasks on a work-stealing pool
+unsigned long long LogAnalyzer::analyzeFiles(const std::vector<LogFile>& files, WorkStealingPool& pool, bool mapped) {
+    return analyzeFiles([&](const FileSink& add) {
+        for (const auto& f : files) add(f);
+    }, pool, mapped);
+}
+
+unsigned long long LogAnalyzer::analyzeFiles(const FileSource& source, WorkStealingPool& pool, bool mapped) {
+    // One state per worker; each is only touched by its own thread and
+    // everything is merged once after the pool drains
+    std::vector<WorkerState> workerStates(pool.size(), newWorkerState());
+    std::atomic<unsigned long long> bytesScanned{0};
+
+    auto localState = [&]() -> WorkerState& {
+        return workerStates[WorkStealingPool::currentWorker()];
+    };
+
+    // Scans one small file whole
+    auto scanSmall = [&](const LogFile& f) {
+        if (mapped) {
+            MappedFile file(f.path);
+            if (!file.isOpen()) {
+                std::cerr << "Error: Could not open file " << f.path << "\n";
+                return;
+            }
+            scanChunk(file.data(), file.data() + file.size(), localState());
+            bytesScanned += file.size();
+        } else if (scanStream(f.path, localState())) {
+            bytesScanned += f.size;
+        }
+    };
+
+    // Maps a large file and splits it at the first newline after every
+    // CHUNK_SIZE boundary; the chunks go onto this worker's deque, where idle
+    // workers steal them. The shared_ptr keeps the mapping alive until the
+    // last chunk is done.
+    auto splitLarge = [&](const LogFile& f) {
+        auto file = std::make_shared<MappedFile>(f.path);
+        if (!file->isOpen()) {
+            std::cerr << "Error: Could not open file " << f.path << "\n";
+            return;
+        }
+        bytesScanned += file->size();
+        const char* p = file->data();
+        const char* end = p + file->size();
+        while (p < end) {
+            const char* cut = end;
+            if (static_cast<size_t>(end - p) > CHUNK_SIZE) {
+                const char* nl = static_cast<const char*>(
+                    std::memchr(p + CHUNK_SIZE, '\n', end - (p + CHUNK_SIZE)));
+                cut = nl ? nl + 1 : end;
             }
+            pool.submit([&, file, p, cut]() { scanChunk(p, cut, localState()); });
+            p = cut;
         }
+    };
+
+    // One step of a stream decoder: decompress a block, queue the next step,
+    // then queue the scan of the block's complete lines. The worker runs its
+    // newest task (the scan) itself while an idle worker steals the next
+    // decode step, so decompression and matching overlap and each file holds
+    // at most a couple of blocks in memory.
+    std::function<void(std::shared_ptr<DecodeJob>)> decodeNext = [&](std::shared_ptr<DecodeJob> job) {
+        auto block = std::make_shared<std::string>(std::move(job->carry));
+        size_t got = job->decoder->read(*block, CHUNK_SIZE);
+        bytesScanned += got;
+        if (got > 0) {
+            cutAtLastLine(*block, job->carry);
+            pool.submit([&, job]() { decodeNext(job); });
+        } else if (job->decoder->failed()) {
+            std::cerr << "Error: Corrupt compressed file " << job->path << "\n";
+        }
+        if (!block->empty())
+            pool.submit([&, block]() { scanChunk(block->data(), block->data() + block->size(), localState()); });
+    };
+
+    // Decompresses every frame of a zstd file as its own task
+    auto splitFrames = [&](std::shared_ptr<MappedFile> file, const std::vector<std::pair<size_t, size_t>>& frames,
+                           const std::string& path) {
+        auto seams = std::make_shared<FrameSeams>();
+        seams->heads.resize(frames.size());
+        seams->tails.resize(frames.size());
+        seams->hasNewline.assign(frames.size(), 0);
+        seams->remaining = frames.size();
+
+        for (size_t i = 0; i < frames.size(); ++i) {
+            pool.submit([&, file, seams, i, frame = frames[i], path]() {
+                std::string out;
+                if (!zstdDecompressFrame(file->data() + frame.first, frame.second, out)) {
+                    std::cerr << "Error: Corrupt compressed file " << path << "\n";
+                    out.clear();
+                }
+                bytesScanned += out.size();
+                WorkerState& state = localState();
+
+                size_t first = out.find('\n');
+                if (first == std::string::npos) {
+                    seams->heads[i] = std::move(out);
+                } else {
+                    size_t last = out.rfind('\n');
+                    seams->hasNewline[i] = 1;
+                    seams->heads[i].assign(out, 0, first);
+                    seams->tails[i].assign(out, last + 1, std::string::npos);
+                    scanChunk(out.data() + first + 1, out.data() + last + 1, state);
+                }
+
+                if (--seams->remaining > 0) return;
+                std::string line;
+                for (size_t f = 0; f < seams->heads.size(); ++f) {
+                    line += seams->heads[f];
+                    if (!seams->hasNewline[f]) continue;
+                    scanChunk(line.data(), line.data() + line.size(), state);
+                    line = std::move(seams->tails[f]);
+                }
+                scanChunk(line.data(), line.data() + line.size(), state);
+            });
+        }
+    };
+
+    auto startCompressed = [&](const LogFile& f) {
+        Compression compression = compressionOf(f.path);
+        if (!compressionSupported(compression)) {
+            std::cerr << "Skipping " << f.path << ": built without " << missingLibrary(compression) << "\n";
+            return;
+        }
+        if (compression == Compression::ZSTD) {
+            auto file = std::make_shared<MappedFile>(f.path);
+            if (!file->isOpen()) {
+                std::cerr << "Error: Could not open file " << f.path << "\n";
+                return;
+            }
+            auto frames = zstdFrames(file->data(), file->size());
+            if (frames.size() > 1) {
+                splitFrames(file, frames, f.path);
+                return;
+            }
+        }
+        auto job = std::make_shared<DecodeJob>();
+        job->decoder = StreamDecoder::open(f.path, compression);
+        job->path = f.path;
+        if (!job->decoder) {
+            std::cerr << "Error: Could not open file " << f.path << "\n";
+            return;
+        }
+        decodeNext(job);
+    };
+
+    // Enqueue: compressed and large files get their own task, small files
+    // are batched. Files may be added from pool tasks (the directory walker),
+    // so the open batch is shared under a lock.
+    std::vector<LogFile> batch;
+    unsigned long long batchBytes = 0;
+    std::mutex batchMutex;
+    auto flushBatch = [&]() { // batchMutex held
+        if (batch.empty()) return;
+        pool.submit([&, files = std::move(batch)]() {
+            for (const LogFile& f : files) scanSmall(f);
+        });
+        batch.clear();
+        batchBytes = 0;
+    };
+    FileSink add = [&](const LogFile& f) {
+        if (compressionOf(f.path) != Compression::NONE) {
+            pool.submit([&, f]() { startCompressed(f); });
+            return;
+        }
+        if (f.size > CHUNK_SIZE) {
+            pool.submit([&, f]() { splitLarge(f); });
+            return;
+        }
+        std::lock_guard<std::mutex> lock(batchMutex);
+        batch.push_back(f);
+        batchBytes += f.size;
+        if (batchBytes >= CHUNK_SIZE) flushBatch();
+    };
+
+    source(add);
+    pool.wait(); // the source is done adding once its tasks have finished
+    {
+        std::lock_guard<std::mutex> lock(batchMutex);
+        flushBatch();
     }
+    pool.wait();
+
+    mergeStates(workerStates);
+    return bytesScanned;
 }
 
 // Function to print summary using std::for_each and a lambda
@@ -31,14 +427,214 @@ void LogAnalyzer::printSummary() const {
 
     std::lock_guard<std::mutex> lock(countMutex);
 
-    std::for_each(keywordCounts.begin(), keywordCounts.end(),
-                  [](const std::pair<std::string, int>& entry) {
-                      std::string key = entry.first;
+    // Report keywords that were seen, in alphabetical order
+    std::vector<size_t> ids;
+    for (size_t id = 0; id < keywordCounts.size(); ++id)
+        if (keywordCounts[id] > 0) ids.push_back(id);
+    std::sort(ids.begin(), ids.end(),
+              [this](size_t a, size_t b) { return keywordNames[a] < keywordNames[b]; });
+
+    std::for_each(ids.begin(), ids.end(),
+                  [this](size_t id) {
+                      std::string key = keywordNames[id];
                       // remove brackets for cleaner display
                       if (!key.empty() && key.front() == '[' && key.back() == ']')
                           key = key.substr(1, key.size() - 2);
-                      std::cout << key << ": " << entry.second << "\n";
+                      std::cout << key << ": " << keywordCounts[id] << "\n";
                   });
 
     std::cout << "-----------------------\n";
+    if (query) std::cout << "Lines matching query: " << matchedLines << "\n";
+}
+
+// Function to print the keyword totals on one line, in keyword order
+void LogAnalyzer::printRunningSummary(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(countMutex);
+    for (size_t id = 0; id < keywordCounts.size(); ++id) {
+        std::string key = keywordNames[id];
+        if (!key.empty() && key.front() == '[' && key.back() == ']')
+            key = key.substr(1, key.size() - 2);
+        out << (id ? "  " : "") << key << ": " << keywordCounts[id];
+    }
+    out << "\n";
+}
+
+// Function to print level, hourly and message-type counts from the table
+void LogAnalyzer::printTableSummary() const {
+    std::lock_guard<std::mutex> lock(countMutex);
+
+    std::cout << "\n--- Lines by Level ---\n";
+    std::vector<long long> byLevel = table.countByLevel();
+    for (int l = 0; l < LOG_LEVEL_COUNT - 1; ++l)
+        if (byLevel[l] > 0) std::cout << levelName(static_cast<LogLevel>(l)) << ": " << byLevel[l] << "\n";
+
+    std::cout << "\n--- Lines by Hour (UTC) ---\n";
+    for (const auto& [hour, count] : table.countByHour())
+        std::cout << formatTimestamp(hour).substr(0, 13) << ":00  " << count << "\n";
+
+    std::cout << "\n--- Lines by Message Type ---\n";
+    std::vector<long long> byType = table.countByMessageType();
+    std::vector<uint32_t> ids(byType.size());
+    for (uint32_t id = 0; id < ids.size(); ++id) ids[id] = id;
+    std::sort(ids.begin(), ids.end(), [&](uint32_t a, uint32_t b) {
+        return byType[a] != byType[b] ? byType[a] > byType[b] : table.messageType(a) < table.messageType(b);
+    });
+    for (uint32_t id : ids)
+        std::cout << byType[id] << "  " << table.messageType(id) << "\n";
+
+    std::cout << "-----------------------\n";
+    std::cout << table.rows() << " rows, " << table.messageTypeCount() << " message types, "
+              << table.unparsed() << " unparsed lines\n";
+}
+
+// Ten counters per reported template keeps the top-K stable even when
+// their counts are close
+void LogAnalyzer::enableTemplates(size_t topK) {
+    buildTemplates = true;
+    templates = TopKSketch(std::max(TopKSketch::DEFAULT_CAPACITY, topK * 10));
+}
+
+// Function to print the most frequent message templates from the sketch
+void LogAnalyzer::printTemplateSummary(size_t topK) const {
+    std::lock_guard<std::mutex> lock(countMutex);
+    std::cout << "\n--- Top Message Templates (approximate) ---\n";
+    for (const auto& entry : templates.top(topK)) {
+        std::cout << entry.count;
+        if (entry.guaranteed < entry.count) std::cout << " (at least " << entry.guaranteed << ")";
+        std::cout << "  " << entry.key << "\n";
+    }
+    std::cout << "-----------------------\n";
+    std::cout << templates.total() << " lines, " << templates.size() << " templates tracked (capacity "
+              << templates.capacity() << "); a count is over by at most "
+              << templates.errorBound() << "\n";
+}
+
+void LogAnalyzer::enableDistinct(const FieldExtractor& field, int64_t bucketSeconds) {
+    buildDistinct = true;
+    distinctField = field;
+    distinct = DistinctCounter(bucketSeconds);
+}
+
+// Function to print distinct-value estimates per level and per time bucket
+void LogAnalyzer::printDistinctSummary(int64_t from, int64_t to) const {
+    std::lock_guard<std::mutex> lock(countMutex);
+    const int levelCount = LOG_LEVEL_COUNT - 1; // UNKNOWN never parses
+    auto printLevels = [&](const DistinctCounter::Row& row) {
+        for (int l = 0; l < levelCount; ++l)
+            if (row.levels[l] > 0)
+                std::cout << "  " << levelName(static_cast<LogLevel>(l)) << ": " << std::llround(row.levels[l]);
+    };
+
+    std::cout << "\n--- Distinct " << distinctField.name() << " (approximate) ---\n";
+    DistinctCounter::Row all = distinct.total(from, to);
+    for (int l = 0; l < levelCount; ++l)
+        if (all.levels[l] > 0)
+            std::cout << levelName(static_cast<LogLevel>(l)) << ": " << std::llround(all.levels[l]) << "\n";
+    std::cout << "All levels: " << std::llround(all.total) << "\n";
+
+    const int64_t width = distinct.bucketWidth();
+    std::cout << "\n--- Distinct " << distinctField.name() << " by "
+              << (width == TimeHistogram::MINUTE ? "Minute" : width == TimeHistogram::HOUR ? "Hour" : "Day")
+              << " (UTC) ---\n";
+    for (const auto& row : distinct.rows(from, to)) {
+        std::cout << formatTimestamp(row.start).substr(0, width == TimeHistogram::DAY ? 10 : 16) << "  "
+                  << std::llround(row.total);
+        printLevels(row);
+        std::cout << "\n";
+    }
+    std::cout << "-----------------------\n";
+    std::cout << distinct.counters() << " counters of " << HyperLogLog::REGISTERS / 1024
+              << " KB each; standard error about 1.6%\n";
+}
+
+namespace {
+// Quotes a string for JSON output
+std::string jsonString(const std::string& s) {
+    std::string out = "\"";
+    for (unsigned char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += static_cast<char>(c);
+        } else if (c < 0x20) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        } else {
+            out += static_cast<char>(c);
+        }
+    }
+    return out + "\"";
+}
+
+// Quotes a CSV field when it needs it
+std::string csvField(const std::string& s) {
+    if (s.find_first_of(",\"\n") == std::string::npos) return s;
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    return out + "\"";
+}
+}
+
+// Function to print the time-bucketed histogram and top message types
+void LogAnalyzer::printTimeReport(const TimeQuery& query, std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(countMutex);
+
+    std::vector<TimeHistogram::Row> rows;
+    if (query.bucketSeconds > 0) rows = histogram.aggregate(query.bucketSeconds, query.from, query.to);
+    std::vector<std::pair<uint32_t, long long>> top;
+    if (query.topN > 0) top = histogram.topMessageTypes(query.topN, query.from, query.to);
+
+    // ERROR and FATAL lines per line in the bucket
+    auto errorRate = [](const TimeHistogram::Row& row) {
+        return row.total() > 0 ? static_cast<double>(row.errors()) / row.total() : 0.0;
+    };
+    const int levelCount = LOG_LEVEL_COUNT - 1; // UNKNOWN never parses
+
+    out << std::fixed << std::setprecision(4);
+    if (query.json) {
+        out << "{";
+        if (query.bucketSeconds > 0) {
+            out << "\n  \"bucket_seconds\": " << query.bucketSeconds << ",\n  \"buckets\": [";
+            for (size_t i = 0; i < rows.size(); ++i) {
+                const auto& row = rows[i];
+                out << (i ? ",\n" : "\n") << "    {\"start\": \"" << formatTimestamp(row.start)
+                    << "\", \"epoch\": " << row.start << ", \"total\": " << row.total();
+                for (int l = 0; l < levelCount; ++l)
+                    out << ", \"" << levelName(static_cast<LogLevel>(l)) << "\": " << row.levels[l];
+                out << ", \"errors\": " << row.errors() << ", \"error_rate\": " << errorRate(row) << "}";
+            }
+            out << (rows.empty() ? "]" : "\n  ]") << (query.topN > 0 ? "," : "");
+        }
+        if (query.topN > 0) {
+            out << "\n  \"top_message_types\": [";
+            for (size_t i = 0; i < top.size(); ++i)
+                out << (i ? ",\n" : "\n") << "    {\"message\": " << jsonString(histogram.messageType(top[i].first))
+                    << ", \"count\": " << top[i].second << "}";
+            out << (top.empty() ? "]" : "\n  ]");
+        }
+        out << "\n}\n";
+    } else {
+        if (query.bucketSeconds > 0) {
+            out << "start,epoch,total";
+            for (int l = 0; l < levelCount; ++l)
+                out << "," << levelName(static_cast<LogLevel>(l));
+            out << ",errors,error_rate\n";
+            for (const auto& row : rows) {
+                out << formatTimestamp(row.start) << "," << row.start << "," << row.total();
+                for (int l = 0; l < levelCount; ++l)
+                    out << "," << row.levels[l];
+                out << "," << row.errors() << "," << errorRate(row) << "\n";
+            }
+        }
+        if (query.topN > 0) {
+            if (query.bucketSeconds > 0) out << "\n";
+            out << "message,count\n";
+            for (const auto& [id, count] : top)
+                out << csvField(histogram.messageType(id)) << "," << count << "\n";
+        }
+    }
+    out << std::defaultfloat;
 }
@@ -1,19 +1,181 @@
 #ifndef LOG_ANALYZER_H
 #define LOG_ANALYZER_H
 
-#include <map>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <memory>
 #include <mutex>
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include "DistinctCounter.h"
+#include "KeywordMatcher.h"
+#include "LogTable.h"
+#include "Query.h"
+#include "TimeHistogram.h"
+#include "TopKSketch.h"
+
+class WorkStealingPool;
+
+// A log file queued for analysis
+struct LogFile {
+    std::string path;
+    unsigned long long size;
+};
+
+// Receives files to scan; may be called from any thread
+using FileSink = std::function<void(const LogFile&)>;
+// Hands files to a sink, possibly from tasks it submits to the pool
+using FileSource = std::function<void(const FileSink&)>;
+
+// What the time report covers and how it is written
+struct TimeQuery {
+    int64_t bucketSeconds = 0; // histogram bucket width; 0 for no histogram
+    int64_t from = TimeHistogram::MIN_TIME; // [from, to) in epoch seconds
+    int64_t to = TimeHistogram::MAX_TIME;
+    size_t topN = 0;           // top message types in the range; 0 for none
+    bool json = false;         // JSON instead of CSV
+};
 
 class LogAnalyzer {
+    // Both drive scanChunk and the worker states themselves
+    friend class LogFollower;
+    friend class Checkpoint;
+
 private:
-    std::map<std::string, int> keywordCounts;
+    // Keywords are interned to dense IDs (duplicates removed); the matcher and
+    // all counters are indexed by those IDs
+    std::vector<std::string> keywordNames;
+    KeywordMatcher matcher; // compiled once from keywordNames
+    std::vector<long long> keywordCounts;
     mutable std::mutex countMutex; // mutable because we'll lock in const function
 
+    bool buildTable = false;
+    LogTable table;
+
+    bool buildHistogram = false;
+    TimeHistogram histogram;
+
+    bool buildTemplates = false;
+    TopKSketch templates;
+
+    bool buildDistinct = false;
+    FieldExtractor distinctField;
+    DistinctCounter distinct;
+
+    // Only lines matching the query are counted, when one is set
+    std::unique_ptr<Query> query;
+    long long matchedLines = 0;
+    long long linesScanned = 0; // not counted when a query skips lines
+
+    // Everything one worker accumulates without locking; merged into the
+    // totals once the worker is done
+    struct WorkerState {
+        std::vector<long long> counts;
+        LogTable table;
+        TimeHistogram histogram;
+        TopKSketch templates;
+        std::string templateText; // scratch for messageTemplate
+        DistinctCounter distinct;
+        long long matchedLines = 0;
+        long long lines = 0;
+        std::vector<int> hits; // scratch for per-line keyword matching
+        std::vector<char> readBuffer; // scanStream's block buffer, reused across files
+    };
+
+    static std::vector<std::string> internKeywords(const std::vector<std::string>& keywords);
+
+    WorkerState newWorkerState() const;
+    void mergeState(const WorkerState& state);
+    // Merges every worker's state into the totals
+    void mergeStates(const std::vector<WorkerState>& states);
+
+    // Whether lines are parsed at all (table, histogram, templates or distinct values)
+    bool parsesLines() const { return buildTable || buildHistogram || buildTemplates || buildDistinct; }
+    // Parses one line into the table, histogram, template sketch and/or
+    // distinct-value counters
+    void parseLine(std::string_view line, WorkerState& state) const;
+
+    // Scans the lines in [begin, end) into a worker's state
+    void scanChunk(const char* begin, const char* end, WorkerState& state) const;
+
+    // Counts one line that passed the query
+    void countMatch(std::string_view line, WorkerState& state) const;
+    // scanChunk with a query: only lines holding the query's required text
+    // are parsed and evaluated
+    void scanMatching(const char* begin, const char* end, WorkerState& state) const;
+
+    // Size of one scanStream read
+    static const size_t STREAM_BLOCK = 1024 * 1024;
+
+    // Reads a file block by block into a worker's state
+    bool scanStream(const std::string& filename, WorkerState& state) const;
+
+    // Decompresses a .log.gz/.log.zst file on this thread, scanning it block
+    // by block into a worker's state; adds the decompressed size to bytes
+    bool scanCompressed(const std::string& filename, WorkerState& state, unsigned long long& bytes) const;
+
 public:
-    void analyzeFile(const std::string& filename, const std::vector<std::string>& keywords);
+    // Target size of one unit of work; larger files are split into
+    // line-aligned chunks of about this size, smaller ones are batched
+    static const size_t CHUNK_SIZE = 4 * 1024 * 1024;
+
+    explicit LogAnalyzer(const std::vector<std::string>& keywords);
+
+    // Keyword list after removing duplicates; position is the keyword ID
+    const std::vector<std::string>& keywords() const { return keywordNames; }
+
+    void analyzeFile(const std::string& filename);
+
+    // Scans all files as tasks on the pool and waits for them. Small files are
+    // batched into tasks of about CHUNK_SIZE; larger files are memory-mapped
+    // and split into chunk tasks that idle workers steal. With mapped set,
+    // small files are mapped too instead of read through ifstream.
+    // Compressed files are decompressed by a chain of tasks that hands
+    // CHUNK_SIZE blocks to scan tasks; multi-frame zstd files decompress
+    // every frame in parallel.
+    // Returns the number of (decompressed) bytes scanned.
+    unsigned long long analyzeFiles(const std::vector<LogFile>& files, WorkStealingPool& pool, bool mapped);
+
+    // Same, for files handed over while the scan is already running, so
+    // discovery overlaps with scanning; returns once source and every scan
+    // task have finished
+    unsigned long long analyzeFiles(const FileSource& source, WorkStealingPool& pool, bool mapped);
+
+    // Also parse every line into the columnar table (timestamp, level, message type)
+    void enableTable() { buildTable = true; }
+    const LogTable& getTable() const { return table; }
+
+    // Restricts every count, the table and the histogram to matching lines
+    void setQuery(const Query& q) { query = std::make_unique<Query>(q); }
+    long long matched() const { return matchedLines; }
+    long long lines() const { return linesScanned; }
+
+    // Also count lines per minute and level for the time report
+    void enableHistogram() { buildHistogram = true; }
+    const TimeHistogram& getHistogram() const { return histogram; }
+
+    // Also count message templates in a Space-Saving sketch (per worker,
+    // merged at the end) to report the most frequent ones in bounded memory
+    void enableTemplates(size_t topK);
+    const TopKSketch& getTemplates() const { return templates; }
+
+    // Also estimate how many distinct values of a field each level has per
+    // time bucket (bucketSeconds wide), with HyperLogLogs merged at the end
+    void enableDistinct(const FieldExtractor& field, int64_t bucketSeconds);
+    const DistinctCounter& getDistinct() const { return distinct; }
+
     void printSummary() const;
+    // One line of current keyword totals, for follow mode
+    void printRunningSummary(std::ostream& out) const;
+    void printTableSummary() const;
+    // The topK most frequent message templates with their error bounds
+    void printTemplateSummary(size_t topK) const;
+    // Distinct values per level over [from, to) and per bucket
+    void printDistinctSummary(int64_t from, int64_t to) const;
+    // Writes the histogram and/or top message types for the query as CSV or JSON
+    void printTimeReport(const TimeQuery& query, std::ostream& out) const;
 };
 
 #endif
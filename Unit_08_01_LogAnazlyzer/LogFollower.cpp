@@ -0,0 +1,244 @@
+#include "LogFollower.h"
+#include "MappedFile.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <filesystem>
+#include <thread>
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+bool isLogName(const std::string& name) {
+    return name.size() > 4 && name.compare(name.size() - 4, 4, ".log") == 0;
+}
+}
+
+LogFollower::LogFollower(LogAnalyzer& analyzer, WorkStealingPool& pool, const std::string& directory)
+    : analyzer(analyzer), pool(pool), directory(directory) {
+#ifdef __linux__
+    // Watch before the first listing so nothing written during catch-up is missed
+    watchFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watchFd >= 0 &&
+        inotify_add_watch(watchFd, directory.c_str(),
+                          IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO) < 0) {
+        ::close(watchFd);
+        watchFd = -1;
+    }
+#endif
+}
+
+LogFollower::~LogFollower() {
+#ifndef _WIN32
+    if (watchFd >= 0) ::close(watchFd);
+#endif
+}
+
+LogFollower::TrackedFile* LogFollower::track(const std::string& name) {
+    auto [it, added] = files.try_emplace(name);
+    if (added) it->second.path = (fs::path(directory) / name).string();
+    return &it->second;
+}
+
+void LogFollower::discover() {
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(directory, ec)) {
+        std::string name = entry.path().filename().string();
+        if (isLogName(name) && entry.is_regular_file(ec)) track(name);
+    }
+}
+
+bool LogFollower::refresh(TrackedFile& file, LogAnalyzer::WorkerState& state) {
+    // A partial line left by a file that is gone or replaced is a complete line
+    auto flushCarry = [&]() {
+        if (file.carry.empty()) return;
+        analyzer.scanChunk(file.carry.data(), file.carry.data() + file.carry.size(), state);
+        file.carry.clear();
+    };
+
+    FileStat st;
+    file.missing = !statFile(file.path, st);
+    if (file.missing) {
+        flushCarry();
+        return false;
+    }
+    if (st.id != file.id || st.size < file.offset) {
+        // Rotated (new inode under the same name) or truncated: start over
+        flushCarry();
+        file.id = st.id;
+        file.offset = 0;
+    }
+    file.target = st.size;
+    return st.size > file.offset;
+}
+
+void LogFollower::readTail(TrackedFile& file, LogAnalyzer::WorkerState& state) {
+#ifdef _WIN32
+    std::ifstream in(file.path, std::ios::binary);
+    if (!in) return;
+    in.seekg(static_cast<std::streamoff>(file.offset));
+    auto readAt = [&](char* buf, size_t n) -> size_t {
+        in.read(buf, static_cast<std::streamsize>(n));
+        return static_cast<size_t>(in.gcount());
+    };
+#else
+    int fd = ::open(file.path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    // The name may have been rotated since refresh; the next round restarts it
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<unsigned long long>(st.st_ino) != file.id) {
+        ::close(fd);
+        return;
+    }
+    auto readAt = [&](char* buf, size_t n) -> size_t {
+        ssize_t got = pread(fd, buf, n, static_cast<off_t>(file.offset));
+        return got > 0 ? static_cast<size_t>(got) : 0;
+    };
+#endif
+
+    std::string buffer = std::move(file.carry);
+    while (file.offset < file.target) {
+        size_t keep = buffer.size();
+        size_t want = static_cast<size_t>(std::min<unsigned long long>(READ_BLOCK, file.target - file.offset));
+        buffer.resize(keep + want);
+        size_t got = readAt(&buffer[keep], want);
+        buffer.resize(keep + got);
+        if (got == 0) break;
+        file.offset += got;
+        bytesRead += got;
+
+        // Scan up to the last newline; the rest waits for the next append
+        size_t nl = buffer.rfind('\n');
+        if (nl != std::string::npos) {
+            analyzer.scanChunk(buffer.data(), buffer.data() + nl + 1, state);
+            buffer.erase(0, nl + 1);
+        }
+        if (buffer.size() >= MAX_CARRY) {
+            analyzer.scanChunk(buffer.data(), buffer.data() + buffer.size(), state);
+            buffer.clear();
+        }
+    }
+    file.carry = std::move(buffer);
+
+#ifndef _WIN32
+    ::close(fd);
+#endif
+}
+
+bool LogFollower::scanRound(const std::vector<std::string>& names) {
+    LogAnalyzer::WorkerState local = analyzer.newWorkerState(); // flushed carries
+    unsigned long long before = bytesRead;
+    bool flushed = false;
+
+    std::vector<TrackedFile*> dirty;
+    std::vector<std::string> gone;
+    auto check = [&](const std::string& name, TrackedFile& file) {
+        bool hadCarry = !file.carry.empty();
+        if (refresh(file, local)) dirty.push_back(&file);
+        flushed = flushed || (hadCarry && file.carry.empty());
+        if (file.missing) gone.push_back(name);
+    };
+    if (names.empty()) {
+        for (auto& [name, file] : files) check(name, file);
+    } else {
+        for (const auto& name : names) check(name, *track(name));
+    }
+
+    // Each file is read by exactly one task; per-worker states are merged after
+    std::vector<LogAnalyzer::WorkerState> states(pool.size(), analyzer.newWorkerState());
+    for (TrackedFile* file : dirty)
+        pool.submit([this, file, &states]() { readTail(*file, states[WorkStealingPool::currentWorker()]); });
+    pool.wait();
+
+    states.push_back(std::move(local));
+    analyzer.mergeStates(states);
+    for (const auto& name : gone) files.erase(name);
+    return flushed || bytesRead != before;
+}
+
+bool LogFollower::waitForChanges(int timeoutMs, std::vector<std::string>& names) {
+#ifdef __linux__
+    if (watchFd >= 0) {
+        pollfd pfd{watchFd, POLLIN, 0};
+        if (poll(&pfd, 1, timeoutMs) <= 0) return false;
+
+        // Drain everything queued so a burst of writes becomes one round
+        alignas(inotify_event) char buf[64 * 1024];
+        ssize_t n;
+        while ((n = ::read(watchFd, buf, sizeof(buf))) > 0) {
+            for (char* p = buf; p < buf + n;) {
+                const inotify_event* ev = reinterpret_cast<const inotify_event*>(p);
+                if (ev->mask & IN_Q_OVERFLOW) return false;
+                if (ev->len > 0) {
+                    std::string name = ev->name;
+                    if (isLogName(name) && std::find(names.begin(), names.end(), name) == names.end())
+                        names.push_back(name);
+                }
+                p += sizeof(inotify_event) + ev->len;
+            }
+        }
+        return true;
+    }
+#endif
+    std::this_thread::sleep_for(std::chrono::milliseconds(std::min(timeoutMs, 250)));
+    return false;
+}
+
+void LogFollower::run(const std::atomic<bool>& stop, const std::function<void()>& onUpdate) {
+    using Clock = std::chrono::steady_clock;
+
+    discover();
+    scanRound({});
+    onUpdate();
+    auto lastUpdate = Clock::now();
+    bool unreported = false;
+
+    while (!stop) {
+        // Idle rounds also re-check every file once a second, which catches
+        // anything the watch missed (and is the only mechanism without inotify)
+        int timeoutMs = 1000;
+        if (unreported) {
+            auto due = lastUpdate + UPDATE_INTERVAL - Clock::now();
+            timeoutMs = static_cast<int>(std::max<long long>(
+                0, std::chrono::duration_cast<std::chrono::milliseconds>(due).count()));
+        }
+
+        std::vector<std::string> names;
+        if (waitForChanges(timeoutMs, names)) {
+            if (!names.empty() && scanRound(names)) unreported = true;
+        } else {
+            discover();
+            if (scanRound({})) unreported = true;
+        }
+
+        if (unreported && Clock::now() - lastUpdate >= UPDATE_INTERVAL) {
+            onUpdate();
+            lastUpdate = Clock::now();
+            unreported = false;
+        }
+    }
+
+    // Pick up the last appends and count unterminated last lines, so the
+    // final totals match a one-shot run over the same files
+    scanRound({});
+    LogAnalyzer::WorkerState local = analyzer.newWorkerState();
+    for (auto& [name, file] : files) {
+        if (file.carry.empty()) continue;
+        analyzer.scanChunk(file.carry.data(), file.carry.data() + file.carry.size(), local);
+        file.carry.clear();
+    }
+    std::vector<LogAnalyzer::WorkerState> states;
+    states.push_back(std::move(local));
+    analyzer.mergeStates(states);
+}
@@ -0,0 +1,79 @@
+#ifndef LOG_FOLLOWER_H
+#define LOG_FOLLOWER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+#include "LogAnalyzer.h"
+
+class WorkStealingPool;
+
+// Keeps a LogAnalyzer's totals current while the .log files in a directory
+// grow. Every file is tracked by identity and byte offset, so only appended
+// bytes are scanned; new files are picked up, rotated files (same name, new
+// inode) restart from the beginning and truncated files from offset zero.
+// Changes are detected with inotify on Linux and by polling elsewhere.
+class LogFollower {
+private:
+    struct TrackedFile {
+        std::string path;
+        unsigned long long id = 0;     // inode, 0 where unavailable
+        unsigned long long offset = 0; // bytes consumed so far
+        unsigned long long target = 0; // size to read up to this round
+        bool missing = false;          // gone from the directory
+        std::string carry;             // trailing partial line
+    };
+
+    LogAnalyzer& analyzer;
+    WorkStealingPool& pool;
+    std::string directory;
+    std::map<std::string, TrackedFile> files; // by file name
+    std::atomic<unsigned long long> bytesRead{0};
+    int watchFd = -1;
+
+    // Lines without a newline are scanned once they reach this size, which
+    // bounds the memory held per file
+    static const size_t MAX_CARRY = 1024 * 1024;
+    static const size_t READ_BLOCK = 1024 * 1024;
+
+    // Adds the .log files of the directory that are not tracked yet
+    void discover();
+    TrackedFile* track(const std::string& name);
+
+    // Checks a file's identity and size; returns true when it has unread bytes.
+    // Partial lines of replaced or vanished files are scanned into state.
+    bool refresh(TrackedFile& file, LogAnalyzer::WorkerState& state);
+
+    // Reads [offset, target) of one file and scans its complete lines
+    void readTail(TrackedFile& file, LogAnalyzer::WorkerState& state);
+
+    // Scans every file in names (all tracked files when names is empty) on the pool
+    bool scanRound(const std::vector<std::string>& names);
+
+    // Waits up to timeoutMs for directory events; fills the names of changed
+    // files. Returns false when the caller should check every file instead.
+    bool waitForChanges(int timeoutMs, std::vector<std::string>& names);
+
+public:
+    // Minimum time between two onUpdate calls
+    static constexpr std::chrono::milliseconds UPDATE_INTERVAL{250};
+
+    LogFollower(LogAnalyzer& analyzer, WorkStealingPool& pool, const std::string& directory);
+    ~LogFollower();
+
+    LogFollower(const LogFollower&) = delete;
+    LogFollower& operator=(const LogFollower&) = delete;
+
+    // Catches up on every file, then follows the directory until stop is set.
+    // onUpdate runs on this thread after the totals changed.
+    void run(const std::atomic<bool>& stop, const std::function<void()>& onUpdate);
+
+    size_t fileCount() const { return files.size(); }
+    unsigned long long bytesScanned() const { return bytesRead; }
+};
+
+#endif
@@ -0,0 +1,135 @@
+#include "LogParser.h"
+#include <cstdio>
+
+namespace {
+const char* const LEVEL_NAMES[LOG_LEVEL_COUNT] = {"TRACE", "DEBUG", "INFO", "WARN", "ERROR", "FATAL", "UNKNOWN"};
+const std::string_view SEPARATOR = " \xE2\x80\x94 "; // " — " in UTF-8
+
+bool readNumber(std::string_view text, size_t pos, size_t digits, int& value) {
+    value = 0;
+    for (size_t i = pos; i < pos + digits; ++i) {
+        if (text[i] < '0' || text[i] > '9') return false;
+        value = value * 10 + (text[i] - '0');
+    }
+    return true;
+}
+
+// Days since 1970-01-01 for a proleptic Gregorian date (H. Hinnant's algorithm)
+int64_t daysFromCivil(int y, int m, int d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const int64_t yoe = y - era * 400;
+    const int64_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+std::string_view trimRight(std::string_view s) {
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\r' || s.back() == '\t')) s.remove_suffix(1);
+    return s;
+}
+}
+
+const char* levelName(LogLevel level) {
+    return LEVEL_NAMES[static_cast<int>(level)];
+}
+
+bool parseLevelName(std::string_view name, LogLevel& level) {
+    for (int i = 0; i < LOG_LEVEL_COUNT - 1; ++i) {
+        if (name == LEVEL_NAMES[i]) {
+            level = static_cast<LogLevel>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseTimestamp(std::string_view text, int64_t& epoch) {
+    if (text.size() < 19 || text[4] != '-' || text[7] != '-' || text[10] != ' ' ||
+        text[13] != ':' || text[16] != ':')
+        return false;
+    int y, mo, d, h, mi, s;
+    if (!readNumber(text, 0, 4, y) || !readNumber(text, 5, 2, mo) || !readNumber(text, 8, 2, d) ||
+        !readNumber(text, 11, 2, h) || !readNumber(text, 14, 2, mi) || !readNumber(text, 17, 2, s))
+        return false;
+    if (mo < 1 || mo > 12 || d < 1 || d > 31 || h > 23 || mi > 59 || s > 60) return false;
+    epoch = daysFromCivil(y, mo, d) * 86400 + h * 3600 + mi * 60 + s;
+    return true;
+}
+
+std::string formatTimestamp(int64_t epoch) {
+    int64_t days = epoch >= 0 ? epoch / 86400 : (epoch - 86399) / 86400;
+    int64_t secs = epoch - days * 86400;
+    // Inverse of daysFromCivil
+    days += 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const int64_t doe = days - era * 146097;
+    const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const int64_t mp = (5 * doy + 2) / 153;
+    const int d = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    const int m = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    const int y = static_cast<int>(yoe + era * 400 + (m <= 2));
+
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%04d-%02d-%02d %02d:%02d:%02d", y, m, d,
+                  static_cast<int>(secs / 3600), static_cast<int>(secs / 60 % 60), static_cast<int>(secs % 60));
+    return buf;
+}
+
+bool parseLogLine(std::string_view line, ParsedLine& out) {
+    if (!parseTimestamp(line, out.epoch)) return false;
+
+    // "[LEVEL]" follows the timestamp after one space
+    if (line.size() < 22 || line[19] != ' ' || line[20] != '[') return false;
+    size_t close = line.find(']', 21);
+    if (close == std::string_view::npos || !parseLevelName(line.substr(21, close - 21), out.level))
+        return false;
+
+    size_t msgStart = close + 1;
+    if (msgStart < line.size() && line[msgStart] == ' ') msgStart++;
+    out.message = trimRight(line.substr(msgStart));
+
+    size_t sep = out.message.find(SEPARATOR);
+    if (sep == std::string_view::npos) {
+        out.messageType = out.message;
+        out.detail = std::string_view();
+    } else {
+        out.messageType = trimRight(out.message.substr(0, sep));
+        out.detail = out.message.substr(sep + SEPARATOR.size());
+    }
+    return true;
+}
+
+void messageTemplate(std::string_view messageType, std::string& out) {
+    out.clear();
+    size_t pos = 0;
+    while (pos < messageType.size()) {
+        if (messageType[pos] == ' ') {
+            out += ' ';
+            pos++;
+            continue;
+        }
+        size_t end = messageType.find(' ', pos);
+        if (end == std::string_view::npos) end = messageType.size();
+        std::string_view word = messageType.substr(pos, end - pos);
+        pos = end;
+
+        size_t eq = word.find('=');
+        size_t keep = eq == std::string_view::npos ? 0 : eq + 1;
+        std::string_view value = word.substr(keep);
+        bool variable = false;
+        for (char c : value) {
+            if (c >= '0' && c <= '9') {
+                variable = true;
+                break;
+            }
+        }
+        if (variable) {
+            out.append(word.data(), keep);
+            out += "<*>";
+        } else {
+            out.append(word.data(), word.size());
+        }
+    }
+}
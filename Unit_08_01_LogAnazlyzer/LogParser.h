@@ -0,0 +1,39 @@
+#ifndef LOG_PARSER_H
+#define LOG_PARSER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Severity levels in increasing order, stored as one byte per line
+enum class LogLevel : uint8_t { TRACE, DEBUG, INFO, WARN, ERROR, FATAL, UNKNOWN };
+const int LOG_LEVEL_COUNT = 7;
+
+// Fields of one line in the form
+// "2025-10-26 09:16:31 [DEBUG] Memory usage exceeded threshold — ditp fd nrsy"
+struct ParsedLine {
+    int64_t epoch = 0;          // seconds since 1970-01-01, timestamp read as UTC
+    LogLevel level = LogLevel::UNKNOWN;
+    std::string_view message;   // everything after the level
+    std::string_view messageType; // message text before the " — " separator
+    std::string_view detail;    // text after the separator (may be empty)
+};
+
+// Splits a line into its fields; returns false when the timestamp or level
+// is malformed. The views point into the line.
+bool parseLogLine(std::string_view line, ParsedLine& out);
+
+// Message type with variable parts masked, so "Retry 3 of job 7f3a" and
+// "Retry 5 of job 9c1e" share the template "Retry <*> of job <*>": every
+// word holding a digit becomes <*> ("key=value" words keep "key="). Writes
+// into out to reuse its buffer.
+void messageTemplate(std::string_view messageType, std::string& out);
+
+const char* levelName(LogLevel level);
+bool parseLevelName(std::string_view name, LogLevel& level);
+
+// "YYYY-MM-DD HH:MM:SS" <-> epoch seconds (UTC)
+bool parseTimestamp(std::string_view text, int64_t& epoch);
+std::string formatTimestamp(int64_t epoch);
+
+#endif
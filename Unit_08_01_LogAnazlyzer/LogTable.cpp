@@ -0,0 +1,63 @@
+#include "LogTable.h"
+#include <algorithm>
+#include <map>
+
+void LogTable::append(const ParsedLine& line) {
+    epochs.push_back(line.epoch);
+    levels.push_back(static_cast<uint8_t>(line.level));
+    messageIds.push_back(messageTypes.intern(line.messageType));
+}
+
+void LogTable::merge(const LogTable& other) {
+    std::vector<uint32_t> remap = messageTypes.mergeFrom(other.messageTypes);
+
+    epochs.insert(epochs.end(), other.epochs.begin(), other.epochs.end());
+    levels.insert(levels.end(), other.levels.begin(), other.levels.end());
+    messageIds.reserve(messageIds.size() + other.messageIds.size());
+    for (uint32_t id : other.messageIds)
+        messageIds.push_back(remap[id]);
+    unparsedLines += other.unparsedLines;
+}
+
+std::vector<long long> LogTable::countByLevel() const {
+    // One std::count pass per level over the byte column; each pass is a
+    // compare-and-add the compiler vectorizes
+    std::vector<long long> counts(LOG_LEVEL_COUNT, 0);
+    for (int l = 0; l < LOG_LEVEL_COUNT; ++l)
+        counts[l] = std::count(levels.begin(), levels.end(), static_cast<uint8_t>(l));
+    return counts;
+}
+
+std::vector<std::pair<int64_t, long long>> LogTable::countByHour() const {
+    std::vector<std::pair<int64_t, long long>> result;
+    if (epochs.empty()) return result;
+
+    auto floorHour = [](int64_t t) { return (t >= 0 ? t : t - 3599) / 3600; };
+    auto range = std::minmax_element(epochs.begin(), epochs.end());
+    int64_t firstHour = floorHour(*range.first);
+    int64_t lastHour = floorHour(*range.second);
+
+    if (lastHour - firstHour < 1000000) {
+        // Dense bucket array over the observed range
+        std::vector<long long> buckets(lastHour - firstHour + 1, 0);
+        for (int64_t t : epochs)
+            buckets[floorHour(t) - firstHour]++;
+        for (size_t i = 0; i < buckets.size(); ++i)
+            if (buckets[i] > 0) result.push_back({(firstHour + static_cast<int64_t>(i)) * 3600, buckets[i]});
+    } else {
+        // Stray timestamps spread over centuries; fall back to a sparse map
+        std::map<int64_t, long long> sparse;
+        for (int64_t t : epochs)
+            sparse[floorHour(t)]++;
+        for (const auto& entry : sparse)
+            result.push_back({entry.first * 3600, entry.second});
+    }
+    return result;
+}
+
+std::vector<long long> LogTable::countByMessageType() const {
+    std::vector<long long> counts(messageTypes.size(), 0);
+    for (uint32_t id : messageIds)
+        counts[id]++;
+    return counts;
+}
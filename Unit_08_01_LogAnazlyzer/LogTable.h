@@ -0,0 +1,48 @@
+#ifndef LOG_TABLE_H
+#define LOG_TABLE_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "LogParser.h"
+#include "StringDictionary.h"
+
+// Parsed log lines stored column by column: one int64 timestamp, one level
+// byte and one dictionary-encoded message type per row. Aggregations are
+// plain loops over a single column instead of re-reading the text.
+class LogTable {
+private:
+    std::vector<int64_t> epochs;
+    std::vector<uint8_t> levels;
+    std::vector<uint32_t> messageIds;
+
+    StringDictionary messageTypes;
+
+    unsigned long long unparsedLines = 0;
+
+public:
+    // Appends one already parsed line
+    void append(const ParsedLine& line);
+    void countUnparsed() { unparsedLines++; }
+
+    // Moves another (per-worker) table's rows in, remapping its message IDs
+    void merge(const LogTable& other);
+
+    size_t rows() const { return epochs.size(); }
+    unsigned long long unparsed() const { return unparsedLines; }
+    const std::vector<int64_t>& epochColumn() const { return epochs; }
+    const std::vector<uint8_t>& levelColumn() const { return levels; }
+    const std::vector<uint32_t>& messageIdColumn() const { return messageIds; }
+    size_t messageTypeCount() const { return messageTypes.size(); }
+    const std::string& messageType(uint32_t id) const { return messageTypes.at(id); }
+
+    // Rows per level, indexed by LogLevel
+    std::vector<long long> countByLevel() const;
+    // (hour start epoch, rows) for every hour that has rows, in time order
+    std::vector<std::pair<int64_t, long long>> countByHour() const;
+    // Rows per message type, indexed by message ID
+    std::vector<long long> countByMessageType() const;
+};
+
+#endif
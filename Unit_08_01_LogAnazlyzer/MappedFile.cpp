@@ -0,0 +1,80 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return;
+    std::ostringstream ss;
+    ss << file.rdbuf();
+    buffer = ss.str();
+    fileData = buffer.data();
+    fileSize = buffer.size();
+    opened = true;
+}
+
+MappedFile::~MappedFile() {}
+
+bool statFile(const std::string& path, FileStat& st) {
+    std::error_code ec;
+    if (!std::filesystem::is_regular_file(path, ec)) return false;
+    st.id = 0;
+    st.size = std::filesystem::file_size(path, ec);
+    st.mtime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::filesystem::last_write_time(path, ec).time_since_epoch()).count();
+    return !ec;
+}
+#else
+MappedFile::MappedFile(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0) {
+        fileSize = static_cast<size_t>(st.st_size);
+        if (fileSize == 0) {
+            opened = true; // empty files cannot be mapped but are still valid
+        } else {
+            void* p = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                // Chunks are scanned front to back, so ask for aggressive readahead
+                madvise(p, fileSize, MADV_SEQUENTIAL);
+                fileData = static_cast<const char*>(p);
+                opened = true;
+            } else {
+                fileSize = 0;
+            }
+        }
+    }
+    ::close(fd); // the mapping stays valid after the descriptor is closed
+}
+
+MappedFile::~MappedFile() {
+    if (fileData && fileSize > 0)
+        munmap(const_cast<char*>(fileData), fileSize);
+}
+
+bool statFile(const std::string& path, FileStat& st) {
+    struct stat info;
+    if (::stat(path.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) return false;
+    st.id = static_cast<unsigned long long>(info.st_ino);
+    st.size = static_cast<unsigned long long>(info.st_size);
+#ifdef __APPLE__
+    const struct timespec& modified = info.st_mtimespec;
+#else
+    const struct timespec& modified = info.st_mtim;
+#endif
+    st.mtime = static_cast<long long>(modified.tv_sec) * 1000000000LL + modified.tv_nsec;
+    return true;
+}
+#endif
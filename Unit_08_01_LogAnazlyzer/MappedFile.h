@@ -0,0 +1,40 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+// Read-only view of a whole file. Uses mmap on POSIX systems and falls back
+// to reading the file into memory elsewhere.
+class MappedFile {
+private:
+    const char* fileData = nullptr;
+    size_t fileSize = 0;
+    bool opened = false;
+#ifdef _WIN32
+    std::string buffer;
+#endif
+
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isOpen() const { return opened; }
+    const char* data() const { return fileData; }
+    size_t size() const { return fileSize; }
+};
+
+// Identity, size and modification time of a regular file
+struct FileStat {
+    unsigned long long id = 0;   // inode, 0 where unavailable
+    unsigned long long size = 0;
+    long long mtime = 0;         // nanoseconds since the epoch
+};
+
+// Returns false when path is missing or not a regular file
+bool statFile(const std::string& path, FileStat& st);
+
+#endif
@@ -0,0 +1,392 @@
+#include "Query.h"
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+namespace {
+std::string upper(std::string s) {
+    for (char& c : s) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    return s;
+}
+
+// "YYYY-MM-DD" means midnight
+bool parseTime(std::string text, int64_t& epoch) {
+    if (text.size() == 10) text += " 00:00:00";
+    return parseTimestamp(text, epoch);
+}
+
+std::string_view fieldValue(int field, std::string_view line, const ParsedLine& parsed) {
+    switch (field) {
+    case 0: return parsed.message;
+    case 1: return parsed.messageType;
+    case 2: return parsed.detail;
+    default: return line;
+    }
+}
+}
+
+// Recursive-descent parser over a simple tokenizer
+class Query::Parser {
+private:
+    struct Token {
+        enum Kind { WORD, STRING, OP, PUNCT, END } kind;
+        std::string text;
+        size_t pos;
+    };
+
+    std::string source;
+    std::vector<Token> tokens;
+    size_t next = 0;
+
+    [[noreturn]] void fail(const std::string& message, size_t pos) const {
+        throw std::invalid_argument(message + " at position " + std::to_string(pos + 1) + " of query");
+    }
+
+    void tokenize() {
+        size_t i = 0;
+        while (i < source.size()) {
+            char c = source[i];
+            if (std::isspace(static_cast<unsigned char>(c))) {
+                i++;
+            } else if (std::isalnum(static_cast<unsigned char>(c)) || c == '_') {
+                size_t start = i;
+                while (i < source.size() && (std::isalnum(static_cast<unsigned char>(source[i])) || source[i] == '_'))
+                    i++;
+                tokens.push_back({Token::WORD, source.substr(start, i - start), start});
+            } else if (c == '"') {
+                // \" and \\ are unescaped; other backslashes are kept for the regex
+                size_t start = i++;
+                std::string text;
+                while (i < source.size() && source[i] != '"') {
+                    if (source[i] == '\\' && i + 1 < source.size() && (source[i + 1] == '"' || source[i + 1] == '\\'))
+                        i++;
+                    text += source[i++];
+                }
+                if (i == source.size()) fail("Unterminated string", start);
+                i++;
+                tokens.push_back({Token::STRING, text, start});
+            } else if (c == '<' || c == '>' || c == '!' || c == '=' || c == '~') {
+                size_t start = i++;
+                if (i < source.size() && (source[i] == '=' || (c == '!' && source[i] == '~'))) i++;
+                std::string op = source.substr(start, i - start);
+                if (op == "!") fail("Expected != or !~", start);
+                tokens.push_back({Token::OP, op, start});
+            } else if (c == '(' || c == ')' || c == '[' || c == ']' || c == ',') {
+                tokens.push_back({Token::PUNCT, std::string(1, c), i++});
+            } else {
+                fail(std::string("Unexpected character '") + c + "'", i);
+            }
+        }
+        tokens.push_back({Token::END, "", source.size()});
+    }
+
+    const Token& peek() const { return tokens[next]; }
+    bool peekWord(const char* word) const { return peek().kind == Token::WORD && upper(peek().text) == word; }
+    bool peekPunct(const char* p) const { return peek().kind == Token::PUNCT && peek().text == p; }
+
+    Token expect(Token::Kind kind, const char* what) {
+        if (peek().kind != kind) fail(std::string("Expected ") + what, peek().pos);
+        return tokens[next++];
+    }
+
+    // A value may be quoted or, for levels, a bare word
+    std::string value(const char* what) {
+        if (peek().kind == Token::STRING || peek().kind == Token::WORD) return tokens[next++].text;
+        fail(std::string("Expected ") + what, peek().pos);
+    }
+
+    int64_t time() {
+        Token t = peek();
+        int64_t epoch = 0;
+        if (!parseTime(value("a time"), epoch)) fail("Expected \"YYYY-MM-DD[ HH:MM:SS]\"", t.pos);
+        return epoch;
+    }
+
+    Node parseOr() {
+        Node left = parseAnd();
+        if (!peekWord("OR")) return left;
+        Node node(Node::OR, {std::move(left)});
+        while (peekWord("OR")) {
+            next++;
+            node.children.push_back(parseAnd());
+        }
+        return node;
+    }
+
+    Node parseAnd() {
+        Node left = parseUnary();
+        if (!peekWord("AND")) return left;
+        Node node(Node::AND, {std::move(left)});
+        while (peekWord("AND")) {
+            next++;
+            node.children.push_back(parseUnary());
+        }
+        return node;
+    }
+
+    Node parseUnary() {
+        if (peekWord("NOT")) {
+            next++;
+            return Node(Node::NOT, {parseUnary()});
+        }
+        if (peekPunct("(")) {
+            next++;
+            Node inner = parseOr();
+            if (!peekPunct(")")) fail("Expected )", peek().pos);
+            next++;
+            return inner;
+        }
+        return parsePredicate();
+    }
+
+    Node parsePredicate() {
+        Token fieldToken = expect(Token::WORD, "a field (level, ts, msg, type, detail, line)");
+        std::string field = upper(fieldToken.text);
+
+        if (field == "TS" && peekWord("IN")) {
+            next++;
+            bool openStart = peekPunct("(");
+            if (!openStart && !peekPunct("[")) fail("Expected [ or (", peek().pos);
+            next++;
+            Node node(Node::TIME);
+            node.from = time() + (openStart ? 1 : 0);
+            expect(Token::PUNCT, ",");
+            node.to = time();
+            if (peekPunct("]")) node.to++;
+            else if (!peekPunct(")")) fail("Expected ] or )", peek().pos);
+            next++;
+            return node;
+        }
+
+        Token opToken = expect(Token::OP, "a comparison");
+        const std::string& op = opToken.text;
+
+        if (field == "LEVEL") {
+            Token t = peek();
+            LogLevel level;
+            if (!parseLevelName(upper(value("a level")), level)) fail("Unknown level", t.pos);
+            int l = static_cast<int>(level);
+            Node node(Node::LEVEL);
+            for (int i = 0; i < LOG_LEVEL_COUNT - 1; ++i) {
+                bool accept = op == "=" ? i == l : op == "!=" ? i != l : op == "<" ? i < l
+                            : op == "<=" ? i <= l : op == ">" ? i > l : op == ">=" ? i >= l : false;
+                if (op == "~" || op == "!~") fail("Levels compare with = != < <= > >=", opToken.pos);
+                if (accept) node.levelMask |= static_cast<uint8_t>(1u << i);
+            }
+            return node;
+        }
+
+        if (field == "TS") {
+            int64_t t = time();
+            Node node(Node::TIME);
+            node.from = INT64_MIN;
+            node.to = INT64_MAX;
+            if (op == "=") { node.from = t; node.to = t + 1; }
+            else if (op == "<") node.to = t;
+            else if (op == "<=") node.to = t + 1;
+            else if (op == ">") node.from = t + 1;
+            else if (op == ">=") node.from = t;
+            else fail("Timestamps compare with = < <= > >= or in", opToken.pos);
+            return node;
+        }
+
+        Node node(Node::TEXT);
+        if (field == "MSG") node.field = Field::MESSAGE;
+        else if (field == "TYPE") node.field = Field::TYPE;
+        else if (field == "DETAIL") node.field = Field::DETAIL;
+        else if (field == "LINE") node.field = Field::LINE;
+        else fail("Unknown field '" + fieldToken.text + "'", fieldToken.pos);
+
+        if (op != "=" && op != "!=" && op != "~" && op != "!~")
+            fail("Text fields compare with = != ~ !~", opToken.pos);
+        Token patternToken = expect(Token::STRING, "a quoted string");
+        node.text = patternToken.text;
+        node.negate = op[0] == '!';
+        node.isRegex = op.back() == '~';
+        if (node.isRegex) {
+            try {
+                node.regex = std::make_shared<const std::regex>(node.text, std::regex::ECMAScript | std::regex::optimize);
+            } catch (const std::regex_error& e) {
+                fail(std::string("Bad regex: ") + e.what(), patternToken.pos);
+            }
+            node.literal = regexLiteral(node.text);
+        } else {
+            node.literal = node.text;
+        }
+        return node;
+    }
+
+public:
+    explicit Parser(const std::string& text) : source(text) { tokenize(); }
+
+    Node parse() {
+        if (peek().kind == Token::END) fail("Empty query", 0);
+        Node node = parseOr();
+        if (peek().kind != Token::END) fail("Unexpected '" + peek().text + "'", peek().pos);
+        return node;
+    }
+};
+
+Query Query::compile(const std::string& text) {
+    Query query;
+    query.root = Parser(text).parse();
+    order(query.root);
+    query.required = requiredLiteral(query.root);
+    return query;
+}
+
+// Costs are rough relative prices per evaluation
+void Query::order(Node& node) {
+    switch (node.kind) {
+    case Node::LEVEL:
+    case Node::TIME:
+        node.cost = 1;
+        return;
+    case Node::TEXT:
+        node.cost = !node.isRegex ? 2 : node.literal.empty() ? 20 : 5;
+        return;
+    default:
+        break;
+    }
+    node.cost = 0;
+    for (auto& child : node.children) {
+        order(child);
+        node.cost += child.cost;
+    }
+    // AND stops at the first false and OR at the first true, so cheap first
+    std::stable_sort(node.children.begin(), node.children.end(),
+                     [](const Node& a, const Node& b) { return a.cost < b.cost; });
+}
+
+std::string Query::requiredLiteral(const Node& node) {
+    switch (node.kind) {
+    case Node::TEXT:
+        return node.negate ? std::string() : node.literal;
+    case Node::LEVEL:
+        // A single accepted level means its bracketed name is on the line
+        for (int l = 0; l < LOG_LEVEL_COUNT - 1; ++l)
+            if (node.levelMask == (1u << l)) return std::string("[") + levelName(static_cast<LogLevel>(l)) + "]";
+        return {};
+    case Node::AND: {
+        std::string best;
+        for (const auto& child : node.children) {
+            std::string lit = requiredLiteral(child);
+            if (lit.size() > best.size()) best = lit;
+        }
+        return best;
+    }
+    default:
+        return {};
+    }
+}
+
+std::string Query::regexLiteral(const std::string& pattern) {
+    // Alternation makes every literal optional
+    if (pattern.find('|') != std::string::npos) return {};
+
+    std::string best, run;
+    bool lastLiteral = false; // whether the last atom is the final char of run
+    int depth = 0;            // literals inside groups are skipped
+    auto endRun = [&]() {
+        if (run.size() > best.size()) best = run;
+        run.clear();
+        lastLiteral = false;
+    };
+
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        char c = pattern[i];
+        switch (c) {
+        case '\\':
+            if (i + 1 < pattern.size() && !std::isalnum(static_cast<unsigned char>(pattern[i + 1]))) {
+                if (depth == 0) {
+                    run += pattern[++i];
+                    lastLiteral = true;
+                } else {
+                    ++i;
+                }
+            } else {
+                ++i; // \d, \w, \b, backreference...
+                endRun();
+            }
+            break;
+        case '[': {
+            size_t j = i + 1;
+            if (j < pattern.size() && pattern[j] == '^') j++;
+            if (j < pattern.size() && pattern[j] == ']') j++;
+            while (j < pattern.size() && pattern[j] != ']') j += pattern[j] == '\\' ? 2 : 1;
+            i = j;
+            endRun();
+            break;
+        }
+        case '(':
+            depth++;
+            endRun();
+            break;
+        case ')':
+            depth = std::max(0, depth - 1);
+            endRun();
+            break;
+        case '*':
+        case '?':
+        case '{':
+            // The previous atom may be absent
+            if (lastLiteral && !run.empty()) run.pop_back();
+            if (c == '{')
+                while (i < pattern.size() && pattern[i] != '}') i++;
+            endRun();
+            if (i + 1 < pattern.size() && pattern[i + 1] == '?') i++; // lazy
+            break;
+        case '+':
+            endRun();
+            if (i + 1 < pattern.size() && pattern[i + 1] == '?') i++;
+            break;
+        case '.':
+        case '^':
+        case '$':
+            endRun();
+            break;
+        default:
+            if (depth == 0) {
+                run += c;
+                lastLiteral = true;
+            }
+            break;
+        }
+    }
+    endRun();
+    return best;
+}
+
+bool Query::evaluate(const Node& node, std::string_view line, const ParsedLine& parsed) {
+    switch (node.kind) {
+    case Node::AND:
+        for (const auto& child : node.children)
+            if (!evaluate(child, line, parsed)) return false;
+        return true;
+    case Node::OR:
+        for (const auto& child : node.children)
+            if (evaluate(child, line, parsed)) return true;
+        return false;
+    case Node::NOT:
+        return !evaluate(node.children[0], line, parsed);
+    case Node::LEVEL:
+        return (node.levelMask >> static_cast<int>(parsed.level)) & 1;
+    case Node::TIME:
+        return parsed.epoch >= node.from && parsed.epoch < node.to;
+    case Node::TEXT: {
+        std::string_view value = fieldValue(static_cast<int>(node.field), line, parsed);
+        bool hit;
+        if (!node.isRegex) hit = value == node.text;
+        else if (!node.literal.empty() && value.find(node.literal) == std::string_view::npos) hit = false;
+        else hit = std::regex_search(value.begin(), value.end(), *node.regex);
+        return hit != node.negate;
+    }
+    }
+    return false;
+}
+
+bool Query::matches(std::string_view line) const {
+    ParsedLine parsed;
+    if (!parseLogLine(line, parsed)) return false;
+    return evaluate(root, line, parsed);
+}
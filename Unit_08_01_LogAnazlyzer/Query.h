@@ -0,0 +1,78 @@
+#ifndef QUERY_H
+#define QUERY_H
+
+#include <cstdint>
+#include <memory>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "LogParser.h"
+
+// A line filter compiled from a small query language:
+//
+//   level>=ERROR AND msg~"Memory.*threshold" AND ts in ["2025-10-26 10:00:00", "2025-10-26 11:00:00")
+//
+//   query     := or
+//   or        := and ("OR" and)*
+//   and       := unary ("AND" unary)*
+//   unary     := "NOT" unary | "(" or ")" | predicate
+//   predicate := "level" (= != < <= > >=) LEVEL
+//              | "ts" (= < <= > >=) TIME | "ts" "in" ("["|"(") TIME "," TIME ("]"|")")
+//              | FIELD (= != ~ !~) "text"      FIELD: msg, type, detail, line
+//
+// TIME is "YYYY-MM-DD HH:MM:SS" or "YYYY-MM-DD"; "~" is an ECMAScript regex
+// search. Keywords and field names are case-insensitive.
+//
+// The plan evaluates cheap predicates first: level and timestamp checks are
+// a byte and an integer comparison, string equality comes next and regexes
+// last. A regex is only run when the literal text it requires (the longest
+// run of plain characters) occurs in the field. The longest literal every
+// matching line must contain is exposed so the caller can skip whole
+// stretches of input without parsing them.
+class Query {
+private:
+    enum class Field { MESSAGE, TYPE, DETAIL, LINE };
+
+    struct Node {
+        enum Kind { AND, OR, NOT, LEVEL, TIME, TEXT };
+        Kind kind;
+        std::vector<Node> children;  // AND, OR, NOT
+        uint8_t levelMask = 0;       // LEVEL: bit per accepted LogLevel
+        int64_t from = 0, to = 0;    // TIME: [from, to)
+        Field field = Field::MESSAGE; // TEXT
+        bool negate = false;          // TEXT: != and !~
+        bool isRegex = false;
+        std::string text;             // TEXT: value or pattern
+        std::string literal;          // TEXT: required substring ("" when none)
+        std::shared_ptr<const std::regex> regex;
+        int cost = 0;
+
+        explicit Node(Kind kind = AND, std::vector<Node> children = {})
+            : kind(kind), children(std::move(children)) {}
+    };
+
+    Node root;
+    std::string required;
+
+    static bool evaluate(const Node& node, std::string_view line, const ParsedLine& parsed);
+    static void order(Node& node);
+    static std::string requiredLiteral(const Node& node);
+
+    class Parser;
+
+public:
+    // Throws std::invalid_argument with a description of the first error
+    static Query compile(const std::string& text);
+
+    // True when the line parses and satisfies the query
+    bool matches(std::string_view line) const;
+
+    // Text that occurs in every matching line ("" when the query has none)
+    const std::string& requiredText() const { return required; }
+
+    // Longest run of plain characters every match of a regex must contain
+    static std::string regexLiteral(const std::string& pattern);
+};
+
+#endif
@@ -0,0 +1,33 @@
+#include "StringDictionary.h"
+
+// The index holds views into the other dictionary's strings, so copies
+// rebuild it against their own storage
+StringDictionary::StringDictionary(const StringDictionary& other) {
+    for (const auto& s : other.strings) intern(s);
+}
+
+StringDictionary& StringDictionary::operator=(const StringDictionary& other) {
+    if (this != &other) {
+        strings.clear();
+        index.clear();
+        for (const auto& s : other.strings) intern(s);
+    }
+    return *this;
+}
+
+uint32_t StringDictionary::intern(std::string_view text) {
+    auto it = index.find(text);
+    if (it != index.end()) return it->second;
+
+    uint32_t id = static_cast<uint32_t>(strings.size());
+    strings.emplace_back(text);
+    index.emplace(std::string_view(strings.back()), id);
+    return id;
+}
+
+std::vector<uint32_t> StringDictionary::mergeFrom(const StringDictionary& other) {
+    std::vector<uint32_t> remap(other.size());
+    for (uint32_t id = 0; id < other.size(); ++id)
+        remap[id] = intern(other.at(id));
+    return remap;
+}
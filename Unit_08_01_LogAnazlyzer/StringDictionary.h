@@ -0,0 +1,35 @@
+#ifndef STRING_DICTIONARY_H
+#define STRING_DICTIONARY_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Assigns dense IDs to strings. The deque keeps each string at a fixed
+// address, so the index can key on views of them and a lookup of an
+// already known string does not allocate.
+class StringDictionary {
+private:
+    std::deque<std::string> strings;
+    std::unordered_map<std::string_view, uint32_t> index;
+
+public:
+    StringDictionary() = default;
+    StringDictionary(const StringDictionary& other);
+    StringDictionary& operator=(const StringDictionary& other);
+    StringDictionary(StringDictionary&&) = default;
+    StringDictionary& operator=(StringDictionary&&) = default;
+
+    uint32_t intern(std::string_view text);
+
+    // Interns every string of other; result[otherId] is the ID in this dictionary
+    std::vector<uint32_t> mergeFrom(const StringDictionary& other);
+
+    size_t size() const { return strings.size(); }
+    const std::string& at(uint32_t id) const { return strings[id]; }
+};
+
+#endif
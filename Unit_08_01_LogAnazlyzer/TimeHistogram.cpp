@@ -0,0 +1,118 @@
+#include "TimeHistogram.h"
+#include <algorithm>
+
+namespace {
+// Start of the width-second bucket holding t, rounding down for negative t
+int64_t floorTo(int64_t t, int64_t width) {
+    int64_t q = t / width;
+    if (t % width != 0 && t < 0) q--;
+    return q * width;
+}
+}
+
+long long TimeHistogram::Row::total() const {
+    long long sum = 0;
+    for (long long c : levels) sum += c;
+    return sum;
+}
+
+long long TimeHistogram::Row::errors() const {
+    return levels[static_cast<int>(LogLevel::ERROR)] + levels[static_cast<int>(LogLevel::FATAL)];
+}
+
+TimeHistogram::Bucket& TimeHistogram::bucketFor(int64_t minute) {
+    if (lastBucket < buckets.size() && buckets[lastBucket].minute == minute)
+        return buckets[lastBucket];
+
+    auto it = bucketIndex.find(minute);
+    if (it != bucketIndex.end()) {
+        lastBucket = it->second;
+    } else {
+        if (!buckets.empty() && buckets.back().minute > minute) sorted = false;
+        lastBucket = buckets.size();
+        buckets.push_back(Bucket{minute, {}, {}});
+        bucketIndex.emplace(minute, lastBucket);
+    }
+    return buckets[lastBucket];
+}
+
+void TimeHistogram::addType(Bucket& bucket, uint32_t id, long long count) {
+    for (auto& entry : bucket.types) {
+        if (entry.first == id) {
+            entry.second += count;
+            return;
+        }
+    }
+    bucket.types.emplace_back(id, count);
+}
+
+void TimeHistogram::add(const ParsedLine& line) {
+    Bucket& bucket = bucketFor(floorTo(line.epoch, MINUTE));
+    bucket.levels[static_cast<int>(line.level)]++;
+    addType(bucket, messageTypes.intern(line.messageType), 1);
+}
+
+void TimeHistogram::merge(const TimeHistogram& other) {
+    std::vector<uint32_t> remap = messageTypes.mergeFrom(other.messageTypes);
+    for (const auto& src : other.buckets) {
+        Bucket& dst = bucketFor(src.minute);
+        for (int l = 0; l < LOG_LEVEL_COUNT; ++l)
+            dst.levels[l] += src.levels[l];
+        for (const auto& [id, count] : src.types)
+            addType(dst, remap[id], count);
+    }
+}
+
+void TimeHistogram::finalize() {
+    if (sorted) return;
+    std::sort(buckets.begin(), buckets.end(),
+              [](const Bucket& a, const Bucket& b) { return a.minute < b.minute; });
+    for (size_t i = 0; i < buckets.size(); ++i)
+        bucketIndex[buckets[i].minute] = i;
+    lastBucket = 0;
+    sorted = true;
+}
+
+std::pair<size_t, size_t> TimeHistogram::range(int64_t from, int64_t to) const {
+    auto byMinute = [](const Bucket& b, int64_t t) { return b.minute < t; };
+    // A minute bucket counts as inside when its start is; a bound in the
+    // middle of a minute takes the whole minute it falls in
+    int64_t first = from == MIN_TIME ? MIN_TIME : floorTo(from, MINUTE);
+    size_t lo = std::lower_bound(buckets.begin(), buckets.end(), first, byMinute) - buckets.begin();
+    size_t hi = std::lower_bound(buckets.begin(), buckets.end(), to, byMinute) - buckets.begin();
+    return {lo, std::max(lo, hi)};
+}
+
+std::vector<TimeHistogram::Row> TimeHistogram::aggregate(int64_t width, int64_t from, int64_t to) const {
+    std::vector<Row> rows;
+    auto [lo, hi] = range(from, to);
+    for (size_t i = lo; i < hi; ++i) {
+        int64_t start = floorTo(buckets[i].minute, width);
+        if (rows.empty() || rows.back().start != start)
+            rows.push_back(Row{start, {}});
+        for (int l = 0; l < LOG_LEVEL_COUNT; ++l)
+            rows.back().levels[l] += buckets[i].levels[l];
+    }
+    return rows;
+}
+
+std::vector<std::pair<uint32_t, long long>> TimeHistogram::topMessageTypes(size_t n, int64_t from,
+                                                                           int64_t to) const {
+    std::vector<long long> counts(messageTypes.size(), 0);
+    auto [lo, hi] = range(from, to);
+    for (size_t i = lo; i < hi; ++i)
+        for (const auto& [id, count] : buckets[i].types)
+            counts[id] += count;
+
+    std::vector<std::pair<uint32_t, long long>> top;
+    for (uint32_t id = 0; id < counts.size(); ++id)
+        if (counts[id] > 0) top.emplace_back(id, counts[id]);
+
+    auto byCount = [this](const auto& a, const auto& b) {
+        return a.second != b.second ? a.second > b.second : messageTypes.at(a.first) < messageTypes.at(b.first);
+    };
+    n = std::min(n, top.size());
+    std::partial_sort(top.begin(), top.begin() + n, top.end(), byCount);
+    top.resize(n);
+    return top;
+}
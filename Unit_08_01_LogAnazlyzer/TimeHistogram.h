@@ -0,0 +1,85 @@
+#ifndef TIME_HISTOGRAM_H
+#define TIME_HISTOGRAM_H
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "LogParser.h"
+#include "StringDictionary.h"
+
+// Line counts pre-bucketed by minute, built in the same pass that scans the
+// files. Each minute keeps one counter per level plus the message types seen
+// in it, so hourly/daily histograms and top-N queries over any time range
+// are answered by summing buckets instead of re-reading lines.
+class TimeHistogram {
+public:
+    static const int64_t MINUTE = 60;
+    static const int64_t HOUR = 3600;
+    static const int64_t DAY = 86400;
+
+    // Whole range, for queries without --from/--to
+    static const int64_t MIN_TIME = std::numeric_limits<int64_t>::min();
+    static const int64_t MAX_TIME = std::numeric_limits<int64_t>::max();
+
+    using LevelCounts = std::array<long long, LOG_LEVEL_COUNT>;
+
+    // One bucket of an aggregated histogram
+    struct Row {
+        int64_t start;
+        LevelCounts levels{};
+
+        long long total() const;
+        // ERROR and FATAL lines
+        long long errors() const;
+    };
+
+private:
+    struct Bucket {
+        int64_t minute; // bucket start, epoch seconds
+        LevelCounts levels{};
+        // (message ID, lines); a minute only holds a handful of types, so a
+        // linear search beats hashing
+        std::vector<std::pair<uint32_t, long long>> types;
+    };
+
+    // Buckets are appended in arrival order and sorted once before queries
+    std::vector<Bucket> buckets;
+    std::unordered_map<int64_t, size_t> bucketIndex;
+    size_t lastBucket = 0; // log lines arrive mostly in time order
+    bool sorted = true;
+
+    StringDictionary messageTypes;
+
+    Bucket& bucketFor(int64_t minute);
+    static void addType(Bucket& bucket, uint32_t id, long long count);
+
+    // Index range of the buckets inside [from, to)
+    std::pair<size_t, size_t> range(int64_t from, int64_t to) const;
+
+public:
+    void add(const ParsedLine& line);
+
+    // Adds another (per-worker) histogram's buckets, remapping its message IDs
+    void merge(const TimeHistogram& other);
+
+    // Puts the buckets in time order; call once after the last add/merge
+    void finalize();
+
+    bool empty() const { return buckets.empty(); }
+    const std::string& messageType(uint32_t id) const { return messageTypes.at(id); }
+
+    // Buckets of width seconds (MINUTE, HOUR, DAY) inside [from, to); only
+    // buckets that have lines are returned, in time order
+    std::vector<Row> aggregate(int64_t width, int64_t from = MIN_TIME, int64_t to = MAX_TIME) const;
+
+    // The n most frequent message types inside [from, to), most frequent
+    // first; ties are broken by message text
+    std::vector<std::pair<uint32_t, long long>> topMessageTypes(size_t n, int64_t from = MIN_TIME,
+                                                                int64_t to = MAX_TIME) const;
+};
+
+#endif
@@ -0,0 +1,157 @@
+#include "TopKSketch.h"
+#include <algorithm>
+#include <functional>
+
+TopKSketch::TopKSketch(size_t capacity) : maxCounters(std::max<size_t>(1, capacity)) {}
+
+void TopKSketch::swapSlots(size_t a, size_t b) {
+    std::swap(heap[a], heap[b]);
+    heapPos[heap[a]] = static_cast<uint32_t>(a);
+    heapPos[heap[b]] = static_cast<uint32_t>(b);
+}
+
+void TopKSketch::siftUp(size_t pos) {
+    while (pos > 0) {
+        size_t parent = (pos - 1) / 2;
+        if (counters[heap[parent]].count <= counters[heap[pos]].count) break;
+        swapSlots(pos, parent);
+        pos = parent;
+    }
+}
+
+void TopKSketch::siftDown(size_t pos) {
+    while (true) {
+        size_t smallest = pos;
+        for (size_t child = 2 * pos + 1; child <= 2 * pos + 2 && child < heap.size(); ++child) {
+            if (counters[heap[child]].count < counters[heap[smallest]].count) smallest = child;
+        }
+        if (smallest == pos) break;
+        swapSlots(pos, smallest);
+        pos = smallest;
+    }
+}
+
+void TopKSketch::rebuildHeap() {
+    heap.resize(counters.size());
+    heapPos.resize(counters.size());
+    for (uint32_t i = 0; i < heap.size(); ++i) heap[i] = heapPos[i] = i;
+    for (size_t pos = heap.size() / 2; pos-- > 0;) siftDown(pos);
+}
+
+// Only a full summary evicts, so only then can an unseen key have been dropped
+long long TopKSketch::minCount() const {
+    return counters.size() < maxCounters || heap.empty() ? 0 : counters[heap[0]].count;
+}
+
+long long TopKSketch::errorBound() const {
+    long long bound = minCount();
+    for (const auto& c : counters) bound = std::max(bound, c.error);
+    return bound;
+}
+
+// Row r uses the hash h1 + r * h2, both taken from one std::hash value
+size_t TopKSketch::slot(size_t row, size_t hash) const {
+    uint64_t h1 = hash;
+    uint64_t h2 = ((static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ULL) >> 32) | 1;
+    return row * SKETCH_WIDTH + static_cast<size_t>((h1 + row * h2) & (SKETCH_WIDTH - 1));
+}
+
+void TopKSketch::sketchAdd(size_t hash, long long count) {
+    if (sketch.empty()) sketch.assign(SKETCH_DEPTH * SKETCH_WIDTH, 0);
+    for (size_t row = 0; row < SKETCH_DEPTH; ++row) sketch[slot(row, hash)] += count;
+}
+
+long long TopKSketch::sketchEstimate(size_t hash) const {
+    long long estimate = sketch[slot(0, hash)];
+    for (size_t row = 1; row < SKETCH_DEPTH; ++row) estimate = std::min(estimate, sketch[slot(row, hash)]);
+    return estimate;
+}
+
+void TopKSketch::add(const std::string& key, long long count) {
+    totalCount += count;
+    sketchAdd(std::hash<std::string>{}(key), count);
+
+    auto it = index.find(key);
+    if (it != index.end()) {
+        counters[it->second].count += count;
+        siftDown(heapPos[it->second]);
+        return;
+    }
+
+    if (counters.size() < maxCounters) {
+        uint32_t id = static_cast<uint32_t>(counters.size());
+        counters.push_back(Counter{key, count, 0});
+        heapPos.push_back(static_cast<uint32_t>(heap.size()));
+        heap.push_back(id);
+        index.emplace(key, id);
+        siftUp(heap.size() - 1);
+        return;
+    }
+
+    // Take over the smallest counter; its count becomes the new key's error
+    uint32_t id = heap[0];
+    Counter& counter = counters[id];
+    index.erase(counter.key);
+    counter.key = key;
+    counter.error = counter.count;
+    counter.count += count;
+    index.emplace(counter.key, id);
+    siftDown(0);
+}
+
+// A key missing from one summary may still have been seen there up to that
+// summary's smallest count, so that much is added to its count and error
+void TopKSketch::merge(const TopKSketch& other) {
+    if (other.totalCount == 0) return;
+
+    long long minThis = minCount();
+    long long minOther = other.minCount();
+    std::vector<Counter> combined;
+    combined.reserve(counters.size() + other.counters.size());
+    for (const auto& c : counters) {
+        auto it = other.index.find(c.key);
+        if (it == other.index.end()) {
+            combined.push_back(Counter{c.key, c.count + minOther, c.error + minOther});
+        } else {
+            const Counter& o = other.counters[it->second];
+            combined.push_back(Counter{c.key, c.count + o.count, c.error + o.error});
+        }
+    }
+    for (const auto& o : other.counters) {
+        if (index.find(o.key) == index.end())
+            combined.push_back(Counter{o.key, o.count + minThis, o.error + minThis});
+    }
+
+    if (combined.size() > maxCounters) {
+        std::nth_element(combined.begin(), combined.begin() + maxCounters, combined.end(),
+                         [](const Counter& a, const Counter& b) { return a.count > b.count; });
+        combined.resize(maxCounters);
+    }
+    counters = std::move(combined);
+    index.clear();
+    for (uint32_t id = 0; id < counters.size(); ++id) index.emplace(counters[id].key, id);
+    rebuildHeap();
+
+    if (!other.sketch.empty()) {
+        if (sketch.empty()) sketch.assign(other.sketch.size(), 0);
+        for (size_t i = 0; i < sketch.size(); ++i) sketch[i] += other.sketch[i];
+    }
+    totalCount += other.totalCount;
+}
+
+std::vector<TopKSketch::Entry> TopKSketch::top(size_t k) const {
+    std::vector<Entry> entries;
+    entries.reserve(counters.size());
+    for (const auto& c : counters) {
+        // Both counts only ever overestimate, so the smaller one is closer
+        long long count = c.count;
+        if (!sketch.empty()) count = std::min(count, sketchEstimate(std::hash<std::string>{}(c.key)));
+        long long guaranteed = std::min(count, std::max(0LL, c.count - c.error));
+        entries.push_back(Entry{c.key, count, guaranteed});
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.count != b.count ? a.count > b.count : a.key < b.key;
+    });
+    if (entries.size() > k) entries.resize(k);
+    return entries;
+}
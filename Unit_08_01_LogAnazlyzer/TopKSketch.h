@@ -0,0 +1,81 @@
+#ifndef TOP_K_SKETCH_H
+#define TOP_K_SKETCH_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Approximate top-K counter over an unbounded stream of strings in fixed
+// memory. A Space-Saving summary keeps at most capacity counters: a new key
+// replaces the smallest counter and inherits its count as error, so every
+// key seen more than total/capacity times is guaranteed to be kept. A small
+// Count-Min sketch next to it tightens the estimate of each kept key.
+// Summaries built by different threads merge into one with the same bounds.
+class TopKSketch {
+public:
+    static const size_t DEFAULT_CAPACITY = 1024;
+
+    // One reported key; its true count lies in [guaranteed, count]
+    struct Entry {
+        std::string key;
+        long long count;
+        long long guaranteed;
+    };
+
+private:
+    static const size_t SKETCH_DEPTH = 4;
+    static const size_t SKETCH_WIDTH = 4096; // power of two
+
+    struct Counter {
+        std::string key;
+        long long count;
+        long long error; // count the key may have inherited
+    };
+
+    size_t maxCounters;
+    std::vector<Counter> counters;
+    // Counter indices as a binary min-heap on count, so the counter to
+    // replace is always heap[0]; heapPos is each counter's heap slot
+    std::vector<uint32_t> heap;
+    std::vector<uint32_t> heapPos;
+    std::unordered_map<std::string, uint32_t> index;
+
+    // SKETCH_DEPTH rows of SKETCH_WIDTH counts; allocated on the first add,
+    // so idle worker states stay small
+    std::vector<long long> sketch;
+    long long totalCount = 0;
+
+    void siftUp(size_t pos);
+    void siftDown(size_t pos);
+    void swapSlots(size_t a, size_t b);
+    void rebuildHeap();
+
+    long long minCount() const;
+    size_t slot(size_t row, size_t hash) const;
+    void sketchAdd(size_t hash, long long count);
+    long long sketchEstimate(size_t hash) const;
+
+public:
+    explicit TopKSketch(size_t capacity = DEFAULT_CAPACITY);
+
+    void add(const std::string& key, long long count = 1);
+
+    // Folds another (per-worker) summary into this one
+    void merge(const TopKSketch& other);
+
+    // The k keys with the highest estimated count, highest first; ties are
+    // broken by key
+    std::vector<Entry> top(size_t k) const;
+
+    // Most any reported count can be over by: the smallest counter once the
+    // summary is full (0 before that, when every count is exact), or more
+    // if merging left a counter with a larger inherited error
+    long long errorBound() const;
+
+    size_t capacity() const { return maxCounters; }
+    size_t size() const { return counters.size(); }
+    long long total() const { return totalCount; }
+};
+
+#endif
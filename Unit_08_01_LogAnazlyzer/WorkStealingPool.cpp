@@ -0,0 +1,106 @@
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+thread_local int workerIndex = -1;
+thread_local const WorkStealingPool* workerPool = nullptr;
+}
+
+WorkStealingPool::WorkStealingPool(unsigned threadCount) {
+    threadCount = std::max(1u, threadCount);
+    for (unsigned i = 0; i < threadCount; ++i)
+        queues.push_back(std::make_unique<Worker>());
+    for (unsigned i = 0; i < threadCount; ++i)
+        threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wakeWorkers.notify_all();
+    for (auto& t : threads)
+        t.join();
+}
+
+int WorkStealingPool::currentWorker() {
+    return workerIndex;
+}
+
+void WorkStealingPool::submit(std::function<void()> task) {
+    // Tasks spawned inside the pool stay with their worker (good locality);
+    // outside submissions are spread round-robin
+    unsigned target = (workerPool == this)
+        ? static_cast<unsigned>(workerIndex)
+        : static_cast<unsigned>(nextQueue++ % queues.size());
+
+    pending++;
+    {
+        // Counted before the push so queued never drops below the real number
+        // of tasks; taking sleepMutex orders it with a worker's sleep check
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        queued++;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues[target]->mtx);
+        queues[target]->tasks.push_back(std::move(task));
+    }
+    wakeWorkers.notify_one();
+}
+
+bool WorkStealingPool::popLocal(unsigned index, std::function<void()>& task) {
+    Worker& w = *queues[index];
+    std::lock_guard<std::mutex> lock(w.mtx);
+    if (w.tasks.empty()) return false;
+    task = std::move(w.tasks.back());
+    w.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(unsigned thief, std::function<void()>& task) {
+    for (size_t i = 1; i < queues.size(); ++i) {
+        Worker& victim = *queues[(thief + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mtx);
+        if (victim.tasks.empty()) continue;
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        stealCount++;
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(unsigned index) {
+    workerIndex = static_cast<int>(index);
+    workerPool = this;
+
+    std::function<void()> task;
+    while (true) {
+        if (popLocal(index, task) || steal(index, task)) {
+            queued--;
+            try {
+                task();
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << "\n";
+            }
+            task = nullptr;
+            if (--pending == 0) {
+                std::lock_guard<std::mutex> lock(doneMutex);
+                allDone.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeWorkers.wait(lock, [this] { return stopping || queued > 0; });
+        if (stopping && queued == 0) return;
+    }
+}
+
+void WorkStealingPool::wait() {
+    std::unique_lock<std::mutex> lock(doneMutex);
+    allDone.wait(lock, [this] { return pending == 0; });
+}
@@ -0,0 +1,60 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size thread pool where every worker owns a task deque. Workers take
+// their newest task first and, when they run dry, steal the oldest task from
+// another worker. Tasks may submit more tasks (e.g. a big file splitting
+// itself into chunks); those land on the submitting worker's own deque.
+class WorkStealingPool {
+private:
+    struct Worker {
+        std::deque<std::function<void()>> tasks;
+        std::mutex mtx;
+    };
+
+    std::vector<std::unique_ptr<Worker>> queues;
+    std::vector<std::thread> threads;
+    std::atomic<bool> stopping{false};
+    std::atomic<size_t> queued{0};   // tasks sitting in a deque
+    std::atomic<size_t> pending{0};  // tasks queued or running
+    std::atomic<size_t> nextQueue{0};
+    std::atomic<unsigned long long> stealCount{0};
+
+    std::mutex sleepMutex;
+    std::condition_variable wakeWorkers;
+    std::mutex doneMutex;
+    std::condition_variable allDone;
+
+    bool popLocal(unsigned index, std::function<void()>& task);
+    bool steal(unsigned thief, std::function<void()>& task);
+    void workerLoop(unsigned index);
+
+public:
+    explicit WorkStealingPool(unsigned threadCount = std::thread::hardware_concurrency());
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void submit(std::function<void()> task);
+
+    // Blocks until every submitted task, including ones spawned by tasks, has finished
+    void wait();
+
+    unsigned size() const { return static_cast<unsigned>(threads.size()); }
+    unsigned long long steals() const { return stealCount; }
+
+    // Index of the pool worker running the caller, or -1 outside the pool
+    static int currentWorker();
+};
+
+#endif
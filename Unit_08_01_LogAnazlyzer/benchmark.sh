@@ -0,0 +1,106 @@
+#!/bin/bash
+# Runs LogAnalyzer over a generated corpus for every thread count and scan
+# mode, and writes one JSON object per run (GB/s, lines/s, peak RSS) to a
+# JSON Lines file. With --baseline, the best run of each configuration is
+# compared against an earlier results file and the script fails when any
+# of them got slower than the tolerance allows.
+#
+#   ./benchmark.sh [--corpus DIR] [--size 1G] [--files 64] [--threads "1 2 4 8"]
+#                  [--runs 3] [--out bench.jsonl] [--baseline old.jsonl] [--tolerance 0.10]
+
+CORPUS=bench_corpus
+SIZE=1G
+FILES=64
+THREADS="1 2 4 8"
+RUNS=3
+OUT=bench.jsonl
+BASELINE=
+TOLERANCE=0.10
+QUERY='level>=ERROR AND msg~"Memory.*threshold"'
+
+while [ $# -gt 0 ]; do
+    case "$1" in
+        --corpus) CORPUS=$2; shift 2 ;;
+        --size) SIZE=$2; shift 2 ;;
+        --files) FILES=$2; shift 2 ;;
+        --threads) THREADS=$2; shift 2 ;;
+        --runs) RUNS=$2; shift 2 ;;
+        --out) OUT=$2; shift 2 ;;
+        --baseline) BASELINE=$2; shift 2 ;;
+        --tolerance) TOLERANCE=$2; shift 2 ;;
+        *) echo "Unknown option: $1"; exit 1 ;;
+    esac
+done
+
+# Build both tools the same way as the Readme; sources.txt is the one list
+# of LogAnalyzer sources both use
+echo "Compiling..."
+g++ -std=c++17 -O2 -pthread -DHAVE_ZLIB $(cat sources.txt) -o LogAnalyzer -lz || exit 1
+g++ -std=c++17 -O2 log_generator.cpp LogParser.cpp -o log_generator || exit 1
+
+if [ ! -d "$CORPUS" ]; then
+    echo "Generating $SIZE corpus in $FILES files..."
+    ./log_generator "$CORPUS" --size "$SIZE" --files "$FILES" || exit 1
+fi
+
+# The first pass only warms the page cache
+./LogAnalyzer "$CORPUS" --mmap > /dev/null
+
+: > "$OUT"
+for t in $THREADS; do
+    for mode in stream mmap query; do
+        case $mode in
+            stream) ARGS=() ;;
+            mmap) ARGS=(--mmap) ;;
+            query) ARGS=(--mmap --query "$QUERY") ;;
+        esac
+        for run in $(seq 1 "$RUNS"); do
+            ./LogAnalyzer "$CORPUS" --threads "$t" "${ARGS[@]}" --json-stats | tail -n 1 >> "$OUT"
+        done
+    done
+done
+
+# Best GB/s per configuration: "mode threads query gb_per_s lines_per_s peak_rss_kb"
+best() {
+    awk '
+    function field(name,   m) {
+        if (match($0, "\"" name "\": [^,}]*")) {
+            m = substr($0, RSTART, RLENGTH); sub(/^[^:]*: /, "", m); gsub(/"/, "", m); return m
+        }
+        return ""
+    }
+    {
+        key = field("mode") " " field("threads") " " field("query")
+        if (!(key in gb) || field("gb_per_s") + 0 > gb[key]) {
+            gb[key] = field("gb_per_s") + 0; lines[key] = field("lines_per_s"); rss[key] = field("peak_rss_kb")
+        }
+    }
+    END { for (k in gb) print k, gb[k], lines[k], rss[k] }' "$1" | sort -k1,1 -k2,2n
+}
+
+echo ""
+echo "mode    threads query  GB/s     lines/s      peak RSS KB"
+best "$OUT" | awk '{ printf "%-7s %-7s %-6s %-8.3f %-12s %s\n", $1, $2, $3, $4, $5 == "null" ? "-" : sprintf("%.0f", $5), $6 }'
+echo "All runs written to $OUT"
+
+if [ -n "$BASELINE" ]; then
+    echo ""
+    best "$BASELINE" > /tmp/bench_baseline.$$
+    best "$OUT" > /tmp/bench_current.$$
+    awk -v tol="$TOLERANCE" '
+        NR == FNR { base[$1 " " $2 " " $3] = $4; next }
+        ($1 " " $2 " " $3) in base {
+            old = base[$1 " " $2 " " $3]
+            if (old > 0 && $4 < old * (1 - tol)) {
+                printf "REGRESSION %s threads=%s query=%s: %.3f GB/s (baseline %.3f)\n", $1, $2, $3, $4, old
+                bad = 1
+            }
+        }
+        END { exit bad }' /tmp/bench_baseline.$$ /tmp/bench_current.$$
+    status=$?
+    rm -f /tmp/bench_baseline.$$ /tmp/bench_current.$$
+    if [ $status -ne 0 ]; then
+        exit 1
+    fi
+    echo "No configuration is more than $TOLERANCE slower than $BASELINE"
+fi
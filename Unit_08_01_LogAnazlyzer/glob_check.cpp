@@ -0,0 +1,38 @@
+// Checks globMatch against the --include/--exclude patterns the Readme
+// documents; prints each failing case and exits non-zero if any fail.
+#include "DirectoryWalker.h"
+#include <cstdio>
+
+struct GlobCase {
+    const char* pattern;
+    const char* text;
+    bool expected;
+};
+
+static const GlobCase CASES[] = {
+    {"**/debug-*.log", "a/b/debug-x.log", true},
+    {"**/debug-*.log", "debug-x.log", true},
+    {"**/debug-*.log", "host/nodebug-x.log", false},
+    {"**/debug-*.log", "nodebug-x.log", false},
+    {"*.log", "app.log", true},
+    {"*.log", "host/app.log", false},
+    {"host/**", "host/a/b.log", true},
+    {"a/**/b.log", "a/b.log", true},
+    {"a/**/b.log", "a/x/y/b.log", true},
+    {"a/**/b.log", "a/xb.log", false},
+    {"app-?.log", "app-1.log", true},
+    {"app-[0-9].log", "app-x.log", false},
+};
+
+int main() {
+    int failures = 0;
+    for (const auto& c : CASES) {
+        if (globMatch(c.pattern, c.text) != c.expected) {
+            std::printf("FAIL globMatch(\"%s\", \"%s\") != %s\n", c.pattern, c.text, c.expected ? "true" : "false");
+            failures++;
+        }
+    }
+    std::printf("%d of %zu glob cases passed\n", static_cast<int>(sizeof(CASES) / sizeof(CASES[0])) - failures,
+                sizeof(CASES) / sizeof(CASES[0]));
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,187 @@
+// Writes synthetic logs in the ErrorLogs format for benchmarks:
+//   "2025-10-26 09:16:31 [DEBUG] Memory usage exceeded threshold — ditp fd nrsy"
+// Total size, file count, level mix and detail length are configurable;
+// the same seed always produces the same corpus.
+#include "LogParser.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+const char* const MESSAGES[] = {
+    "Memory usage exceeded threshold", "Unexpected token in configuration file", "Cache cleared successfully",
+    "Connection established successfully", "File not found in the specified path", "Transaction completed",
+    "New session started", "Unhandled exception occurred in module", "Retrying operation due to timeout",
+    "User authentication failed"};
+const int MESSAGE_COUNT = sizeof(MESSAGES) / sizeof(MESSAGES[0]);
+
+struct Options {
+    std::string outDir;
+    unsigned long long bytes = 64ull << 20;
+    int files = 1;
+    // Default mix, in level order TRACE..FATAL
+    std::vector<double> levelWeights = {10, 20, 40, 15, 10, 5};
+    double detailMean = 16; // mean length of the text after " — "
+    double detailSpread = 0.6; // sigma of the log-normal length
+    double linesPerSecond = 50;
+    int64_t start = 1761436800; // 2025-10-26 00:00:00
+    unsigned seed = 42;
+};
+
+// "64M", "2G", "500K" or plain bytes
+bool parseSize(const std::string& text, unsigned long long& bytes) {
+    char* end = nullptr;
+    double value = std::strtod(text.c_str(), &end);
+    if (end == text.c_str() || value < 0) return false;
+    std::string unit(end);
+    double scale = unit.empty() ? 1 : unit == "K" ? 1 << 10 : unit == "M" ? 1 << 20 : unit == "G" ? 1 << 30 : 0;
+    if (scale == 0) return false;
+    bytes = static_cast<unsigned long long>(value * scale);
+    return true;
+}
+
+// "TRACE=10,DEBUG=20,INFO=40,WARN=15,ERROR=10,FATAL=5"; missing levels get 0
+bool parseLevels(const std::string& text, std::vector<double>& weights) {
+    weights.assign(LOG_LEVEL_COUNT - 1, 0);
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        size_t eq = item.find('=');
+        LogLevel level;
+        if (eq == std::string::npos || !parseLevelName(item.substr(0, eq), level)) return false;
+        weights[static_cast<int>(level)] = std::atof(item.c_str() + eq + 1);
+    }
+    return std::any_of(weights.begin(), weights.end(), [](double w) { return w > 0; });
+}
+
+// Lower-case words separated by single spaces, about length bytes in total
+void appendDetail(std::string& out, size_t length, std::mt19937_64& rng) {
+    std::uniform_int_distribution<int> letter('a', 'z'), wordLength(2, 12);
+    size_t written = 0;
+    int word = wordLength(rng);
+    while (written < length) {
+        if (word-- == 0 && written + 1 < length) {
+            out += ' ';
+            word = wordLength(rng);
+        } else {
+            out += static_cast<char>(letter(rng));
+        }
+        written++;
+    }
+}
+
+bool writeFile(const std::string& path, unsigned long long bytes, const Options& options, unsigned seed) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+
+    std::mt19937_64 rng(seed);
+    std::discrete_distribution<int> level(options.levelWeights.begin(), options.levelWeights.end());
+    std::uniform_int_distribution<int> message(0, MESSAGE_COUNT - 1);
+    std::lognormal_distribution<double> detail(
+        std::log(options.detailMean) - options.detailSpread * options.detailSpread / 2, options.detailSpread);
+    std::exponential_distribution<double> gap(options.linesPerSecond);
+
+    std::string buffer;
+    buffer.reserve((1 << 20) + 4096);
+    double clock = static_cast<double>(options.start);
+    unsigned long long written = 0;
+    bool ok = true;
+    while (written < bytes && ok) {
+        buffer.clear();
+        while (buffer.size() < (1u << 20) && written + buffer.size() < bytes) {
+            clock += gap(rng);
+            buffer += formatTimestamp(static_cast<int64_t>(clock));
+            buffer += " [";
+            buffer += levelName(static_cast<LogLevel>(level(rng)));
+            buffer += "] ";
+            buffer += MESSAGES[message(rng)];
+            buffer += " \xE2\x80\x94 ";
+            appendDetail(buffer, std::max<size_t>(1, static_cast<size_t>(detail(rng))), rng);
+            buffer += '\n';
+        }
+        ok = std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+        written += buffer.size();
+    }
+    return std::fclose(file) == 0 && ok;
+}
+
+void usage(const char* program) {
+    std::cerr << "Usage: " << program << " <out_directory> [--size 64M] [--files N]\n"
+              << "       [--levels TRACE=10,DEBUG=20,INFO=40,WARN=15,ERROR=10,FATAL=5]\n"
+              << "       [--detail-length MEAN[:SIGMA]] [--rate LINES_PER_SECOND]\n"
+              << "       [--start \"YYYY-MM-DD HH:MM:SS\"] [--seed N]\n";
+}
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        usage(argv[0]);
+        return 1;
+    }
+    Options options;
+    options.outDir = argv[1];
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        bool ok = hasValue;
+        if (arg == "--size" && hasValue) {
+            ok = parseSize(argv[++i], options.bytes);
+        } else if (arg == "--files" && hasValue) {
+            options.files = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--levels" && hasValue) {
+            ok = parseLevels(argv[++i], options.levelWeights);
+        } else if (arg == "--detail-length" && hasValue) {
+            std::string v = argv[++i];
+            options.detailMean = std::atof(v.c_str());
+            size_t colon = v.find(':');
+            if (colon != std::string::npos) options.detailSpread = std::atof(v.c_str() + colon + 1);
+            ok = options.detailMean >= 1 && options.detailSpread >= 0;
+        } else if (arg == "--rate" && hasValue) {
+            options.linesPerSecond = std::atof(argv[++i]);
+            ok = options.linesPerSecond > 0;
+        } else if (arg == "--start" && hasValue) {
+            ok = parseTimestamp(argv[++i], options.start);
+        } else if (arg == "--seed" && hasValue) {
+            options.seed = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::cerr << "Bad option: " << arg << "\n";
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::error_code ec;
+    fs::create_directories(options.outDir, ec);
+    if (ec) {
+        std::cerr << "Error: Could not create " << options.outDir << "\n";
+        return 1;
+    }
+
+    // Sizes are spread evenly; every file covers the same time span like
+    // logs from hosts running side by side
+    for (int f = 0; f < options.files; ++f) {
+        unsigned long long share = options.bytes / options.files + (f < static_cast<int>(options.bytes % options.files));
+        char name[32];
+        std::snprintf(name, sizeof(name), "gen_%05d.log", f);
+        std::string path = (fs::path(options.outDir) / name).string();
+        if (!writeFile(path, share, options, options.seed + f)) {
+            std::cerr << "Error: Could not write " << path << "\n";
+            return 1;
+        }
+    }
+    std::cout << "Wrote " << options.bytes << " bytes in " << options.files << " file"
+              << (options.files == 1 ? "" : "s") << " to " << options.outDir << "\n";
+    return 0;
+}
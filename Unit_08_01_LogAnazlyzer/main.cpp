@@ -1,25 +1,180 @@
+#include "Checkpoint.h"
+#include "CompressedInput.h"
+#include "DirectoryWalker.h"
 #include "LogAnalyzer.h"
+#include "LogFollower.h"
+#include "WorkStealingPool.h"
 #include <iostream>
+#include <fstream>
 #include <filesystem>
 #include <thread>
 #include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <csignal>
+#include <atomic>
+#include <ctime>
+#include <mutex>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
 
 namespace fs = std::filesystem;
 
+// Set by Ctrl-C to end --follow
+static std::atomic<bool> stopRequested{false};
+
+static void onInterrupt(int) {
+    stopRequested = true;
+}
+
+// Peak resident set size of this process in KB (0 where not measured)
+static long long peakRssKb() {
+#ifdef _WIN32
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024; // bytes on macOS
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+// Accepts "YYYY-MM-DD HH:MM:SS" or a bare "YYYY-MM-DD" (midnight UTC)
+static bool parseTimeArg(std::string text, int64_t& epoch) {
+    if (text.size() == 10) text += " 00:00:00";
+    return parseTimestamp(text, epoch);
+}
+
 int main(int argc, char* argv[]) {
     if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <log_directory>\n";
+        std::cerr << "Usage: " << argv[0] << " <log_directory> [--mmap] [--threads N] [--table] [--follow]\n"
+                  << "       [--checkpoint FILE] [--query QUERY]\n"
+                  << "       [--include GLOB]... [--exclude GLOB]... [--no-recurse] [--json-stats]\n"
+                  << "       [--histogram minute|hour|day] [--top N] [--from TIME] [--to TIME]\n"
+                  << "       [--format csv|json] [--out FILE] [--templates K]\n"
+                  << "       [--distinct detail|last|word:N|key:NAME] [--distinct-by minute|hour|day]\n";
         return 1;
     }
 
     std::string folderPath = argv[1];
-    LogAnalyzer analyzer;
+    bool mappedMode = false;
+    bool tableMode = false;
+    bool followMode = false;
+    unsigned threadCount = std::max(1u, std::thread::hardware_concurrency());
+    TimeQuery timeQuery;
+    std::string reportPath;
+    std::string checkpointPath;
+    std::string queryText;
+    WalkOptions walkOptions;
+    bool jsonStats = false;
+    size_t templateCount = 0;
+    std::string distinctSpec;
+    int64_t distinctBucket = TimeHistogram::HOUR;
+
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--mmap") {
+            mappedMode = true;
+        } else if (arg == "--table") {
+            tableMode = true;
+        } else if (arg == "--follow") {
+            followMode = true;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threadCount = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--histogram" && i + 1 < argc) {
+            std::string unit = argv[++i];
+            if (unit == "minute") timeQuery.bucketSeconds = TimeHistogram::MINUTE;
+            else if (unit == "hour") timeQuery.bucketSeconds = TimeHistogram::HOUR;
+            else if (unit == "day") timeQuery.bucketSeconds = TimeHistogram::DAY;
+            else {
+                std::cerr << "Histogram bucket must be minute, hour or day\n";
+                return 1;
+            }
+        } else if (arg == "--top" && i + 1 < argc) {
+            timeQuery.topN = std::max(1, std::atoi(argv[++i]));
+        } else if ((arg == "--from" || arg == "--to") && i + 1 < argc) {
+            if (!parseTimeArg(argv[++i], arg == "--from" ? timeQuery.from : timeQuery.to)) {
+                std::cerr << "Time must be \"YYYY-MM-DD\" or \"YYYY-MM-DD HH:MM:SS\"\n";
+                return 1;
+            }
+        } else if (arg == "--format" && i + 1 < argc) {
+            std::string format = argv[++i];
+            if (format != "csv" && format != "json") {
+                std::cerr << "Format must be csv or json\n";
+                return 1;
+            }
+            timeQuery.json = format == "json";
+        } else if (arg == "--out" && i + 1 < argc) {
+            reportPath = argv[++i];
+        } else if (arg == "--checkpoint" && i + 1 < argc) {
+            checkpointPath = argv[++i];
+        } else if (arg == "--query" && i + 1 < argc) {
+            queryText = argv[++i];
+        } else if (arg == "--include" && i + 1 < argc) {
+            walkOptions.include.push_back(argv[++i]);
+        } else if (arg == "--exclude" && i + 1 < argc) {
+            walkOptions.exclude.push_back(argv[++i]);
+        } else if (arg == "--no-recurse") {
+            walkOptions.recursive = false;
+        } else if (arg == "--templates" && i + 1 < argc) {
+            templateCount = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--distinct" && i + 1 < argc) {
+            distinctSpec = argv[++i];
+        } else if (arg == "--distinct-by" && i + 1 < argc) {
+            std::string unit = argv[++i];
+            if (unit == "minute") distinctBucket = TimeHistogram::MINUTE;
+            else if (unit == "hour") distinctBucket = TimeHistogram::HOUR;
+            else if (unit == "day") distinctBucket = TimeHistogram::DAY;
+            else {
+                std::cerr << "Distinct bucket must be minute, hour or day\n";
+                return 1;
+            }
+        } else if (arg == "--json-stats") {
+            jsonStats = true;
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    // The checkpoint only caches unfiltered keyword counts per file
+    if (!checkpointPath.empty() && (followMode || tableMode || timeQuery.bucketSeconds > 0 || timeQuery.topN > 0 ||
+                                    !queryText.empty() || templateCount > 0 ||
+                                    !distinctSpec.empty())) {
+        std::cerr << "--checkpoint cannot be combined with --follow, --table, --histogram, --top, --query, --templates"
+                  << " or --distinct\n";
+        return 1;
+    }
 
     std::vector<std::string> keywords = {
         "[WARN]", "[ERROR]", "[FATAL]", "[INFO]", "[DEBUG]", "[TRACE]"
     };
 
-    std::vector<std::thread> threads;
+    LogAnalyzer analyzer(keywords);
+    if (tableMode) analyzer.enableTable();
+    if (templateCount > 0) analyzer.enableTemplates(templateCount);
+    if (!queryText.empty()) {
+        try {
+            analyzer.setQuery(Query::compile(queryText));
+        } catch (const std::invalid_argument& e) {
+            std::cerr << e.what() << "\n";
+            return 1;
+        }
+    }
+    if (!distinctSpec.empty()) {
+        try {
+            analyzer.enableDistinct(FieldExtractor::parse(distinctSpec), distinctBucket);
+        } catch (const std::invalid_argument& e) {
+            std::cerr << e.what() << "\n";
+            return 1;
+        }
+    }
+    bool timeReport = timeQuery.bucketSeconds > 0 || timeQuery.topN > 0;
+    if (timeReport) analyzer.enableHistogram();
 
     try {
         if (!fs::exists(folderPath) || !fs::is_directory(folderPath)) {
@@ -29,24 +184,107 @@ int main(int argc, char* argv[]) {
 
         std::cout << "Analyzing folder: " << folderPath << "\n\n";
 
-        for (const auto& entry : fs::directory_iterator(folderPath)) {
-            if (entry.is_regular_file() && entry.path().extension() == ".log") {
-                threads.emplace_back(&LogAnalyzer::analyzeFile, &analyzer,
-                                     entry.path().string(), keywords);
+        auto start = std::chrono::steady_clock::now();
+
+        // Every file is a task on a fixed pool, so the thread count no longer
+        // depends on how many files the directory holds
+        WorkStealingPool pool(threadCount);
+        size_t fileCount = 0;
+        unsigned long long totalBytes = 0;
+
+        if (followMode) {
+            // Catch up, then rescan appended bytes until Ctrl-C
+            LogFollower follower(analyzer, pool, folderPath);
+            std::signal(SIGINT, onInterrupt);
+            std::signal(SIGTERM, onInterrupt);
+            std::cout << "Following " << folderPath << " (Ctrl-C to stop)\n";
+            follower.run(stopRequested, [&]() {
+                std::time_t now = std::time(nullptr);
+                char stamp[16];
+                std::strftime(stamp, sizeof(stamp), "%H:%M:%S", std::localtime(&now));
+                std::cout << stamp << "  ";
+                analyzer.printRunningSummary(std::cout);
+                std::cout.flush();
+            });
+            fileCount = follower.fileCount();
+            totalBytes = follower.bytesScanned();
+        } else {
+            // Subdirectories are listed in parallel on the same pool
+            DirectoryWalker walker(walkOptions);
+            if (checkpointPath.empty()) {
+                // Files are scanned while the rest of the tree is still being listed
+                totalBytes = analyzer.analyzeFiles([&](const FileSink& add) { walker.walk(folderPath, pool, add); },
+                                                   pool, mappedMode);
+            } else {
+                // The checkpoint needs the whole list to tell removed files apart
+                std::vector<LogFile> files;
+                std::mutex filesMutex;
+                walker.walk(folderPath, pool, [&](const LogFile& f) {
+                    std::lock_guard<std::mutex> lock(filesMutex);
+                    files.push_back(f);
+                });
+                pool.wait();
+
+                // Only bytes past each file's recorded offset are read
+                Checkpoint checkpoint(checkpointPath);
+                bool loaded = checkpoint.load(analyzer.keywords());
+                Checkpoint::Stats stats = checkpoint.update(analyzer, files, pool);
+                totalBytes = stats.bytesScanned;
+                if (!checkpoint.save(analyzer.keywords()))
+                    std::cerr << "Error: Could not write checkpoint " << checkpointPath << "\n";
+                std::cout << "Checkpoint " << (loaded ? "loaded" : "created") << ": " << stats.unchanged
+                          << " unchanged, " << stats.appended << " appended, " << stats.rescanned
+                          << " scanned whole, " << stats.removed << " removed\n";
             }
+            fileCount = walker.filesFound();
         }
 
-        // Join all threads
-        for (auto& t : threads) {
-            if (t.joinable())
-                t.join();
-        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
         analyzer.printSummary();
+        if (tableMode) analyzer.printTableSummary();
+        if (templateCount > 0) analyzer.printTemplateSummary(templateCount);
+        if (!distinctSpec.empty()) analyzer.printDistinctSummary(timeQuery.from, timeQuery.to);
+        if (timeReport) {
+            if (reportPath.empty()) {
+                std::cout << "\n";
+                analyzer.printTimeReport(timeQuery, std::cout);
+            } else {
+                std::ofstream report(reportPath);
+                if (!report) {
+                    std::cerr << "Error: Could not write " << reportPath << "\n";
+                    return 1;
+                }
+                analyzer.printTimeReport(timeQuery, report);
+                std::cout << "\nTime report written to " << reportPath << "\n";
+            }
+        }
 
         std::cout << "\nAnalysis complete. Processed "
-                  << threads.size() << " file"
-                  << (threads.size() == 1 ? "" : "s") << ".\n";
+                  << fileCount << " file"
+                  << (fileCount == 1 ? "" : "s") << ".\n";
+        std::cout << "Peak threads: " << pool.size() + 1 << " (" << pool.size()
+                  << " worker" << (pool.size() == 1 ? "" : "s") << " + main), "
+                  << pool.steals() << " tasks stolen.\n";
+        std::cout << "Scanned " << totalBytes << " bytes in " << seconds << " s ("
+                  << (seconds > 0 ? totalBytes / seconds / 1e9 : 0.0) << " GB/s).\n";
+
+        // One JSON object as the last line, for benchmark.sh and other tools
+        if (jsonStats) {
+            std::cout << "{\"mode\": \"" << (followMode ? "follow" : mappedMode ? "mmap" : "stream")
+                      << "\", \"threads\": " << pool.size() << ", \"query\": " << (queryText.empty() ? "false" : "true")
+                      << ", \"files\": " << fileCount << ", \"bytes\": " << totalBytes
+                      << ", \"lines\": ";
+            // Lines skipped by a query's prefilter are never counted
+            if (queryText.empty()) std::cout << analyzer.lines();
+            else std::cout << "null";
+            std::cout << ", \"seconds\": " << seconds
+                      << ", \"gb_per_s\": " << (seconds > 0 ? totalBytes / seconds / 1e9 : 0.0)
+                      << ", \"lines_per_s\": ";
+            if (queryText.empty()) std::cout << (seconds > 0 ? analyzer.lines() / seconds : 0.0);
+            else std::cout << "null";
+            std::cout << ", \"peak_rss_kb\": " << peakRssKb() << "}\n";
+        }
 
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << "\n";
@@ -0,0 +1,81 @@
+// Compares the per-keyword find() loop with KeywordMatcher as the keyword
+// list grows. The six level keywords are always included; the rest are
+// random words, so the matcher's cost should stay flat while the naive
+// loop grows linearly with the keyword count.
+#include "KeywordMatcher.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+static std::string randomWord(std::mt19937& rng, int minLen, int maxLen) {
+    std::uniform_int_distribution<int> len(minLen, maxLen), letter('a', 'z');
+    std::string w(len(rng), ' ');
+    for (auto& c : w) c = static_cast<char>(letter(rng));
+    return w;
+}
+
+// Lines in the ErrorLogs format: "2025-10-26 09:16:31 [LEVEL] Message — token"
+static std::string makeCorpus(size_t bytes, std::mt19937& rng) {
+    const char* levels[] = {"[WARN]", "[ERROR]", "[FATAL]", "[INFO]", "[DEBUG]", "[TRACE]"};
+    const char* messages[] = {"Memory usage exceeded threshold", "Unexpected token in configuration file",
+                              "Cache cleared successfully", "New session started", "Disk quota nearly full"};
+    std::string out;
+    out.reserve(bytes + 256);
+    while (out.size() < bytes) {
+        out += "2025-10-26 09:16:31 ";
+        out += levels[rng() % 6];
+        out += ' ';
+        out += messages[rng() % 5];
+        out += " \xE2\x80\x94 ";
+        out += randomWord(rng, 4, 36);
+        out += '\n';
+    }
+    return out;
+}
+
+static std::vector<long long> naiveCount(const std::string& corpus, const std::vector<std::string>& keywords) {
+    std::vector<long long> counts(keywords.size(), 0);
+    size_t start = 0;
+    while (start < corpus.size()) {
+        size_t nl = corpus.find('\n', start);
+        if (nl == std::string::npos) nl = corpus.size();
+        std::string_view line(corpus.data() + start, nl - start);
+        for (size_t k = 0; k < keywords.size(); ++k)
+            if (line.find(keywords[k]) != std::string_view::npos) counts[k]++;
+        start = nl + 1;
+    }
+    return counts;
+}
+
+int main(int argc, char* argv[]) {
+    size_t megabytes = argc >= 2 ? std::strtoul(argv[1], nullptr, 10) : 16;
+    std::mt19937 rng(42);
+    std::string corpus = makeCorpus(megabytes << 20, rng);
+    const double mb = corpus.size() / 1e6;
+
+    std::printf("corpus: %.1f MB\n", mb);
+    std::printf("%9s %14s %14s %8s\n", "keywords", "find() MB/s", "matcher MB/s", "match");
+
+    for (size_t count : {6, 25, 100, 250, 500, 1000}) {
+        std::vector<std::string> keywords = {"[WARN]", "[ERROR]", "[FATAL]", "[INFO]", "[DEBUG]", "[TRACE]"};
+        while (keywords.size() < count) keywords.push_back(randomWord(rng, 5, 12));
+
+        auto t0 = std::chrono::steady_clock::now();
+        std::vector<long long> expected = naiveCount(corpus, keywords);
+        auto t1 = std::chrono::steady_clock::now();
+        KeywordMatcher matcher(keywords);
+        std::vector<long long> counts(keywords.size(), 0);
+        matcher.countLines(corpus.data(), corpus.data() + corpus.size(), counts);
+        auto t2 = std::chrono::steady_clock::now();
+
+        double naiveSec = std::chrono::duration<double>(t1 - t0).count();
+        double matcherSec = std::chrono::duration<double>(t2 - t1).count();
+        std::printf("%9zu %14.1f %14.1f %8s\n", count, mb / naiveSec, mb / matcherSec,
+                    counts == expected ? "ok" : "DIFF");
+    }
+    return 0;
+}
@@ -7,7 +7,7 @@ rm -f *.o
 
 # Compile the program
 echo "Compiling..."
-clang++ -std=c++17 -Wall -Wextra main.cpp json_processor.cpp file_utils.cpp -o user_profile_updater
+clang++ -std=c++17 -Wall -Wextra -pthread main.cpp json_processor.cpp json_rewriter.cpp perfect_hash.cpp mapped_file.cpp file_utils.cpp -o user_profile_updater
 
 if [ $? -eq 0 ]; then
     echo "Compilation successful!"
@@ -3,9 +3,74 @@
 #include <chrono>
 #include <iomanip>
 #include <sstream>
+#include <system_error>
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#endif
 
 namespace fs = std::filesystem;
 
+namespace {
+fs::path temporaryPathFor(const fs::path& path) {
+    return fs::path(path.string() + ".tmp");
+}
+
+// Renames temp over path if everything before succeeded; otherwise, or if
+// the rename fails, removes temp
+bool commit(const fs::path& temp, const fs::path& path, bool ok) {
+    std::error_code ec;
+    if (ok) {
+        fs::rename(temp, path, ec);
+        if (!ec) return true;
+    }
+    fs::remove(temp, ec);
+    return false;
+}
+
+#ifndef _WIN32
+bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+#endif
+
+#ifdef __linux__
+// Copies inFd to outFd without bringing the bytes into the process: a
+// reflink where the filesystem supports one (btrfs, XFS), otherwise
+// copy_file_range. False if neither works here, e.g. on old kernels.
+bool copyInKernel(int inFd, int outFd, size_t size) {
+#ifdef FICLONE
+    if (::ioctl(outFd, FICLONE, inFd) == 0) return true;
+#endif
+    while (size > 0) {
+        ssize_t copied = ::copy_file_range(inFd, nullptr, outFd, nullptr, size, 0);
+        if (copied < 0 && errno == EINTR) continue;
+        if (copied <= 0) return false;
+        size -= static_cast<size_t>(copied);
+    }
+    return true;
+}
+#endif
+}
+
 std::string FileUtils::createOutputDirectory() {
     std::string timestamp = getCurrentTimestamp();
     std::string dirName = "user_profiles_updated_" + timestamp;
@@ -31,4 +96,48 @@ std::string FileUtils::getCurrentTimestamp() {
     oss << std::put_time(&tm, "%Y%m%d_%H%M%S");
     
     return oss.str();
-}
\ No newline at end of file
+}
+
+bool FileUtils::writeFileAtomic(const fs::path& path, std::string_view data) {
+    fs::path temp = temporaryPathFor(path);
+    bool ok = false;
+#ifdef _WIN32
+    std::ofstream output(temp, std::ios::binary);
+    if (output.is_open()) {
+        output.write(data.data(), static_cast<std::streamsize>(data.size()));
+        output.close();
+        ok = static_cast<bool>(output);
+    }
+#else
+    // One write() straight from data; a stream would copy it through its own buffer
+    int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    if (fd < 0) return false;
+    ok = writeAll(fd, data.data(), data.size());
+    ok = ::close(fd) == 0 && ok;
+#endif
+    return commit(temp, path, ok);
+}
+
+bool FileUtils::copyFileAtomic(const fs::path& from, const fs::path& path) {
+    fs::path temp = temporaryPathFor(path);
+#ifdef __linux__
+    int inFd = ::open(from.c_str(), O_RDONLY | O_CLOEXEC);
+    if (inFd < 0) return false;
+    struct stat info;
+    int outFd = -1;
+    bool ok = false;
+    if (::fstat(inFd, &info) == 0) {
+        outFd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+        if (outFd >= 0) ok = copyInKernel(inFd, outFd, static_cast<size_t>(info.st_size));
+    }
+    ::close(inFd);
+    if (outFd >= 0) {
+        ok = ::close(outFd) == 0 && ok;
+        if (ok) return commit(temp, path, true);
+    }
+    // Fall through to the portable copy, which overwrites the partial temp
+#endif
+    std::error_code ec;
+    fs::copy_file(from, temp, fs::copy_options::overwrite_existing, ec);
+    return commit(temp, path, !ec);
+}
@@ -1,12 +1,21 @@
 #ifndef FILE_UTILS_H
 #define FILE_UTILS_H
 
+#include <filesystem>
 #include <string>
+#include <string_view>
 
 class FileUtils {
 public:
     static std::string createOutputDirectory();
     static std::string getCurrentTimestamp();
+
+    // Both write to a temporary file next to path and rename it into place,
+    // so path is either absent or complete, never half written. They return
+    // false on failure and leave no temporary file behind.
+    static bool writeFileAtomic(const std::filesystem::path& path, std::string_view data);
+    // On Linux the data is shared (reflink) or copied inside the kernel
+    static bool copyFileAtomic(const std::filesystem::path& from, const std::filesystem::path& path);
 };
 
 #endif // FILE_UTILS_H
\ No newline at end of file
@@ -1,118 +1,180 @@
 #include "json_processor.h"
+#include "file_utils.h"
+#include "mapped_file.h"
+#include "work_queue.h"
+#include <algorithm>
+#include <atomic>
 #include <iostream>
-#include <fstream>
-#include <regex>
-#include <sstream>
-
-JsonProcessor::JsonProcessor() {
-    // Initialize replacement map with JSON objects as strings
-    replacementMap["\"enabled\""] = R"({"status": "enabled", "since": "2024-10-01"})";
-    replacementMap["\"disabled\""] = R"({"status": "disabled", "since": "2024-10-01"})";
-    replacementMap["\"manage_users\""] = R"({"permission": "manage_users", "granted_at": "2024-10-05", "level": "full"})";
-    replacementMap["\"view_content\""] = R"({"permission": "view_content", "granted_at": "2024-09-25", "level": "read-only"})";
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+// Files in flight between two stages; bounds memory whatever the tree size
+const size_t QUEUE_CAPACITY = 1024;
+// Files between two progress lines; one line per file slowed large runs
+const size_t PROGRESS_INTERVAL = 1000;
+// Output buffers larger than this are freed after use rather than kept for
+// the next file, so one huge profile does not pin its memory for the run
+const size_t MAX_RECYCLED_BUFFER = 1 << 20;
+}
+
+JsonProcessor::JsonProcessor(unsigned threadCount)
+    : workerCount(threadCount > 0 ? threadCount : std::max(1u, std::thread::hardware_concurrency())) {
+    // Replace email domains in every string value
+    rewriter.addSubstringRule("$..*", "@company.com", "@newcompany.com");
+
+    // Replace account and notification states with JSON objects
+    for (const char* path : {"$.status", "$.preferences.notifications"}) {
+        rewriter.addValueRule(path, "enabled", R"({"status": "enabled", "since": "2024-10-01"})");
+        rewriter.addValueRule(path, "disabled", R"({"status": "disabled", "since": "2024-10-01"})");
+    }
+
+    // Replace permission names with grant objects
+    rewriter.addValueRule("$.permissions[*]", "manage_users", R"({"permission": "manage_users", "granted_at": "2024-10-05", "level": "full"})");
+    rewriter.addValueRule("$.permissions[*]", "view_content", R"({"permission": "view_content", "granted_at": "2024-09-25", "level": "read-only"})");
+    rewriter.compile();
 }
 
 size_t JsonProcessor::processDirectory(const std::string& inputDir, const std::string& outputDir) {
+    // Three stages connected by bounded queues: this thread discovers files,
+    // a worker pool reads and transforms them, and writer threads save them
+    WorkQueue<FileJob> transformQueue(QUEUE_CAPACITY);
+    WorkQueue<WriteJob> writeQueue(QUEUE_CAPACITY);
+    // Written buffers go back to the workers, so steady state allocates nothing
+    unsigned writerCount = std::max(1u, workerCount / 2);
+    WorkQueue<std::string> spareBuffers(workerCount + writerCount);
+    std::atomic<size_t> doneCount{0};
+    auto fileDone = [&]() {
+        size_t done = ++doneCount;
+        if (done % PROGRESS_INTERVAL == 0) reportProgress(done);
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < workerCount; ++i) {
+        workers.emplace_back([&]() {
+            FileJob job;
+            std::string buffer; // kept while files need no rewrite
+            while (transformQueue.pop(job)) {
+                if (buffer.capacity() == 0) spareBuffers.tryPop(buffer);
+                WriteJob result;
+                result.content = std::move(buffer);
+                buffer = std::string();
+                if (transformJsonFile(job, result)) {
+                    if (result.unchanged && result.content.capacity() <= MAX_RECYCLED_BUFFER)
+                        buffer = std::move(result.content);
+                    writeQueue.push(std::move(result));
+                } else {
+                    copyUnprocessed(job.inputFile, job.outputFile);
+                    fileDone();
+                }
+            }
+        });
+    }
+
+    std::vector<std::thread> writers;
+    for (unsigned i = 0; i < writerCount; ++i) {
+        writers.emplace_back([&]() {
+            WriteJob job;
+            while (writeQueue.pop(job)) {
+                if (!writeJsonFile(job)) copyUnprocessed(job.inputFile, job.outputFile);
+                fileDone();
+                if (!job.unchanged && job.content.capacity() <= MAX_RECYCLED_BUFFER) {
+                    job.content.clear();
+                    spareBuffers.tryPush(std::move(job.content));
+                }
+            }
+        });
+    }
+
+    // Lets every queued file finish, then stops the threads
+    auto finish = [&]() {
+        transformQueue.close();
+        for (auto& t : workers) t.join();
+        writeQueue.close();
+        for (auto& t : writers) t.join();
+    };
+
     size_t processedCount = 0;
-    
     try {
-        // Create output directory structure and process files
+        std::unordered_set<std::string> createdDirs;
         for (const auto& entry : fs::recursive_directory_iterator(inputDir)) {
             if (entry.is_regular_file() && entry.path().extension() == ".json") {
                 // Calculate relative path and create corresponding output path
-                fs::path relativePath = fs::relative(entry.path(), inputDir);
+                fs::path relativePath = entry.path().lexically_relative(inputDir);
                 fs::path outputFile = fs::path(outputDir) / relativePath;
-                
-                // Create output directory if it doesn't exist
-                fs::create_directories(outputFile.parent_path());
-                
-                // Process the JSON file
-                processJsonFile(entry.path(), outputFile);
+
+                // Each output directory is created once, before any of its
+                // files is queued, so workers never have to check
+                fs::path outputParent = outputFile.parent_path();
+                if (createdDirs.insert(outputParent.string()).second)
+                    fs::create_directories(outputParent);
+
+                transformQueue.push(FileJob{entry.path(), outputFile});
                 processedCount++;
-                
-                std::cout << "Processed: " << entry.path() << " -> " << outputFile << std::endl;
             }
         }
     } catch (const fs::filesystem_error& e) {
+        finish();
         std::cerr << "Filesystem error: " << e.what() << std::endl;
         throw;
     }
-    
+
+    finish();
     return processedCount;
 }
 
-void JsonProcessor::processJsonFile(const fs::path& inputFile, const fs::path& outputFile) {
+void JsonProcessor::reportProgress(size_t doneCount) {
+    std::lock_guard<std::mutex> lock(consoleMutex);
+    std::cout << "Processed " << doneCount << " files..." << std::endl;
+}
+
+bool JsonProcessor::transformJsonFile(const FileJob& job, WriteJob& result) {
     try {
-        // Read entire file content
-        std::ifstream inputStream(inputFile);
-        if (!inputStream.is_open()) {
-            throw std::runtime_error("Cannot open file: " + inputFile.string());
-        }
-        
-        std::stringstream buffer;
-        buffer << inputStream.rdbuf();
-        std::string content = buffer.str();
-        inputStream.close();
-        
-        // Transform JSON content
-        std::string transformedContent = transformJsonContent(content);
-        
-        // Write transformed content to output file
-        std::ofstream outputStream(outputFile);
-        if (!outputStream.is_open()) {
-            throw std::runtime_error("Cannot create output file: " + outputFile.string());
+        // Mapped rather than read, so the input is never copied into a string
+        MappedFile input(job.inputFile);
+        if (!input.isOpen()) {
+            throw std::runtime_error("Cannot open file: " + job.inputFile.string());
         }
-        
-        outputStream << transformedContent;
-        outputStream.close();
-        
+
+        // One pass: each string value is rewritten by the rules for its path
+        // as it is read. Output is only built once a rule matches.
+        std::string_view content = input.view();
+        result.inputFile = job.inputFile;
+        result.outputFile = job.outputFile;
+        result.content.clear();
+        result.content.reserve(content.size() + content.size() / 4);
+        result.unchanged = rewriter.rewrite(content, result.content) == 0;
+        return true;
+
     } catch (const std::exception& e) {
-        std::cerr << "Error processing file " << inputFile << ": " << e.what() << std::endl;
-        
-        // Copy file as-is if processing fails
-        try {
-            fs::copy_file(inputFile, outputFile, fs::copy_options::overwrite_existing);
-            std::cout << "Copied (unprocessed): " << inputFile << std::endl;
-        } catch (const fs::filesystem_error& copyError) {
-            std::cerr << "Failed to copy file " << inputFile << ": " << copyError.what() << std::endl;
-        }
+        std::lock_guard<std::mutex> lock(consoleMutex);
+        std::cerr << "Error processing file " << job.inputFile << ": " << e.what() << std::endl;
+        return false;
     }
 }
 
-std::string JsonProcessor::transformJsonContent(const std::string& content) {
-    std::string result = content;
-    
-    // Replace email domains
-    std::regex emailRegex("@company\\.com");
-    result = std::regex_replace(result, emailRegex, "@newcompany.com");
-    
-    // Replace values using the replacement map
-    for (const auto& [oldValue, newValue] : replacementMap) {
-        size_t pos = 0;
-        while ((pos = result.find(oldValue, pos)) != std::string::npos) {
-            // Check if this is a standalone value (not part of a larger string)
-            bool isStandalone = true;
-            if (pos > 0) {
-                char prevChar = result[pos - 1];
-                if (std::isalnum(prevChar) || prevChar == '_' || prevChar == '"') {
-                    isStandalone = false;
-                }
-            }
-            if (pos + oldValue.length() < result.length()) {
-                char nextChar = result[pos + oldValue.length()];
-                if (std::isalnum(nextChar) || nextChar == '_' || nextChar == '"') {
-                    isStandalone = false;
-                }
-            }
-            
-            if (isStandalone) {
-                result.replace(pos, oldValue.length(), newValue);
-                pos += newValue.length();
-            } else {
-                pos += oldValue.length();
-            }
-        }
+bool JsonProcessor::writeJsonFile(const WriteJob& job) {
+    // Unchanged files are copied by the kernel without passing through here;
+    // both paths write a temporary file and rename it, so an interrupted
+    // run never leaves a truncated profile
+    bool written = job.unchanged ? FileUtils::copyFileAtomic(job.inputFile, job.outputFile)
+                                 : FileUtils::writeFileAtomic(job.outputFile, job.content);
+    if (written) return true;
+    std::lock_guard<std::mutex> lock(consoleMutex);
+    std::cerr << "Error processing file " << job.inputFile << ": Cannot create output file: "
+              << job.outputFile.string() << std::endl;
+    return false;
+}
+
+void JsonProcessor::copyUnprocessed(const fs::path& inputFile, const fs::path& outputFile) {
+    // Copy file as-is if processing fails, through a temporary file like
+    // every other output
+    bool copied = FileUtils::copyFileAtomic(inputFile, outputFile);
+    std::lock_guard<std::mutex> lock(consoleMutex);
+    if (copied) {
+        std::cout << "Copied (unprocessed): " << inputFile << std::endl;
+    } else {
+        std::cerr << "Failed to copy file " << inputFile << " to " << outputFile << std::endl;
     }
-    
-    return result;
-}
\ No newline at end of file
+}
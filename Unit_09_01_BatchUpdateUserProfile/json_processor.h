@@ -3,20 +3,42 @@
 
 #include <string>
 #include <filesystem>
-#include <map>
+#include <mutex>
+#include "json_rewriter.h"
 
 namespace fs = std::filesystem;
 
 class JsonProcessor {
 public:
-    JsonProcessor();
+    // threadCount transform workers; 0 means one per core
+    explicit JsonProcessor(unsigned threadCount = 0);
     size_t processDirectory(const std::string& inputDir, const std::string& outputDir);
-    
+
 private:
-    void processJsonFile(const fs::path& inputFile, const fs::path& outputFile);
-    std::string transformJsonContent(const std::string& content);
-    
-    std::map<std::string, std::string> replacementMap;
+    // A file found by discovery
+    struct FileJob {
+        fs::path inputFile;
+        fs::path outputFile;
+    };
+    // A transformed file waiting to be written
+    struct WriteJob {
+        fs::path inputFile;
+        fs::path outputFile;
+        std::string content;    // reused buffer, recycled once written
+        bool unchanged = false; // no rule matched; content is empty and the input is copied
+    };
+
+    // Reads and transforms one file into result.content, which is cleared
+    // first; returns false if it could not be read
+    bool transformJsonFile(const FileJob& job, WriteJob& result);
+    bool writeJsonFile(const WriteJob& job);
+    void copyUnprocessed(const fs::path& inputFile, const fs::path& outputFile);
+    // Prints how many files are done; called once per batch of files
+    void reportProgress(size_t doneCount);
+
+    JsonRewriter rewriter; // built once; shared read-only by the workers
+    unsigned workerCount;
+    std::mutex consoleMutex; // keeps messages from different threads on separate lines
 };
 
-#endif // JSON_PROCESSOR_H
\ No newline at end of file
+#endif // JSON_PROCESSOR_H
@@ -0,0 +1,354 @@
+#include "json_rewriter.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <unordered_set>
+#include <utility>
+
+namespace {
+// Position just past the object or array starting at p, or end if it is
+// never closed. Strings are skipped whole so brackets inside them do not count.
+const char* skipContainer(const char* p, const char* end) {
+    int depth = 0;
+    while (p < end) {
+        char c = *p++;
+        if (c == '{' || c == '[') {
+            depth++;
+        } else if (c == '}' || c == ']') {
+            if (--depth == 0) return p;
+        } else if (c == '"') {
+            while (p < end && *p != '"') p += *p == '\\' ? 2 : 1;
+            if (p >= end) return end;
+            ++p;
+        }
+    }
+    return end;
+}
+
+bool isNameChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '-' || c == '@' || c == '$';
+}
+}
+
+std::vector<JsonRewriter::Step> JsonRewriter::parsePath(const std::string& path) {
+    auto fail = [&](const std::string& what) {
+        throw std::invalid_argument("Bad JSON path \"" + path + "\": " + what);
+    };
+    if (path.empty() || path[0] != '$') fail("must start with $");
+
+    std::vector<Step> steps;
+    size_t i = 1;
+    while (i < path.size()) {
+        Step step;
+        if (path[i] == '.') {
+            i++;
+            if (i < path.size() && path[i] == '.') {
+                step.descendant = true;
+                i++;
+            }
+        } else if (path[i] != '[') {
+            fail("expected . or [ at position " + std::to_string(i));
+        }
+        if (i >= path.size()) fail("ends after a dot");
+
+        if (path[i] == '[') {
+            size_t close = path.find(']', i);
+            if (close == std::string::npos) fail("missing ]");
+            std::string inside = path.substr(i + 1, close - i - 1);
+            if (inside == "*") {
+                step.kind = Step::ANY;
+            } else if (!inside.empty() && inside.find_first_not_of("0123456789") == std::string::npos) {
+                step.kind = Step::INDEX;
+                step.index = std::stoul(inside);
+            } else if (inside.size() >= 2 && (inside[0] == '\'' || inside[0] == '"') && inside.back() == inside[0]) {
+                step.kind = Step::KEY;
+                step.name = inside.substr(1, inside.size() - 2);
+            } else {
+                fail("expected [*], [N] or ['name']");
+            }
+            i = close + 1;
+        } else if (path[i] == '*') {
+            step.kind = Step::ANY;
+            i++;
+        } else {
+            size_t begin = i;
+            while (i < path.size() && isNameChar(path[i])) i++;
+            if (i == begin) fail("expected a name at position " + std::to_string(i));
+            step.kind = Step::KEY;
+            step.name = path.substr(begin, i - begin);
+        }
+        steps.push_back(std::move(step));
+    }
+    return steps;
+}
+
+JsonRewriter::Pattern& JsonRewriter::patternFor(const std::string& path) {
+    for (auto& pattern : patterns)
+        if (pattern.path == path) return pattern;
+    patterns.push_back(Pattern{path, parsePath(path), {}});
+    return patterns.back();
+}
+
+void JsonRewriter::addRule(const std::string& path, Rule rule) {
+    Pattern& pattern = patternFor(path);
+    rules.push_back(std::move(rule));
+    pattern.rules.push_back(rules.size() - 1);
+    states.clear(); // needs compile() again
+}
+
+void JsonRewriter::addValueRule(const std::string& path, const std::string& value, const std::string& replacementJson) {
+    addRule(path, Rule{value, replacementJson, false});
+}
+
+void JsonRewriter::addSubstringRule(const std::string& path, const std::string& from, const std::string& to) {
+    if (!from.empty()) addRule(path, Rule{from, to, true});
+}
+
+// Subset construction: an automaton state is the set of (path, steps
+// matched) positions the current location can be at. The alphabet is every
+// key and index named by some path plus "any other key" and "any other index".
+void JsonRewriter::compile() {
+    // Position id -> (pattern, steps matched); pattern p's positions start at base[p]
+    std::vector<std::pair<size_t, size_t>> positions;
+    std::vector<int> base;
+    for (size_t p = 0; p < patterns.size(); ++p) {
+        base.push_back(static_cast<int>(positions.size()));
+        for (size_t pos = 0; pos <= patterns[p].steps.size(); ++pos) positions.emplace_back(p, pos);
+    }
+
+    keyNames.clear();
+    std::vector<size_t> indices;
+    for (const auto& pattern : patterns) {
+        for (const auto& step : pattern.steps) {
+            if (step.kind == Step::KEY && std::find(keyNames.begin(), keyNames.end(), step.name) == keyNames.end())
+                keyNames.push_back(step.name);
+            if (step.kind == Step::INDEX && std::find(indices.begin(), indices.end(), step.index) == indices.end())
+                indices.push_back(step.index);
+        }
+    }
+
+    states.clear();
+    std::vector<std::vector<int>> sets;
+    std::map<std::vector<int>, int> stateIds;
+    auto intern = [&](std::vector<int> set) {
+        std::sort(set.begin(), set.end());
+        set.erase(std::unique(set.begin(), set.end()), set.end());
+        auto it = stateIds.find(set);
+        if (it != stateIds.end()) return it->second;
+        int id = static_cast<int>(sets.size());
+        stateIds.emplace(set, id);
+        sets.push_back(std::move(set));
+        states.emplace_back();
+        return id;
+    };
+    intern({}); // DEAD
+    std::vector<int> startSet;
+    for (size_t p = 0; p < patterns.size(); ++p) startSet.push_back(base[p]);
+    start = intern(startSet);
+
+    for (size_t s = 1; s < sets.size(); ++s) { // sets grows as new states are found
+        const std::vector<int> current = sets[s]; // intern() may reallocate sets
+        auto follow = [&](auto matches) {
+            std::vector<int> next;
+            for (int id : current) {
+                const auto& [p, pos] = positions[id];
+                if (pos == patterns[p].steps.size()) continue;
+                const Step& step = patterns[p].steps[pos];
+                if (matches(step)) next.push_back(id + 1);
+                if (step.descendant) next.push_back(id); // may match deeper still
+            }
+            return intern(std::move(next));
+        };
+
+        PathState state;
+        state.live = !current.empty();
+        state.otherKeyNext = follow([](const Step& step) { return step.kind == Step::ANY; });
+        std::vector<std::pair<std::string_view, size_t>> keyEntries;
+        for (const auto& name : keyNames) {
+            int next = follow([&](const Step& step) {
+                return step.kind == Step::ANY || (step.kind == Step::KEY && step.name == name);
+            });
+            if (next != state.otherKeyNext) keyEntries.emplace_back(name, static_cast<size_t>(next));
+        }
+        state.keyNext.build(keyEntries);
+        state.otherIndexNext = follow([](const Step& step) { return step.kind == Step::ANY; });
+        for (size_t index : indices) {
+            int next = follow([&](const Step& step) {
+                return step.kind == Step::ANY || (step.kind == Step::INDEX && step.index == index);
+            });
+            if (next != state.otherIndexNext) state.indexNext.emplace(index, next);
+        }
+
+        // Paths fully matched here; earlier rules take precedence
+        std::vector<size_t> accepted;
+        for (int id : current) {
+            const auto& [p, pos] = positions[id];
+            if (pos == patterns[p].steps.size())
+                accepted.insert(accepted.end(), patterns[p].rules.begin(), patterns[p].rules.end());
+        }
+        std::sort(accepted.begin(), accepted.end());
+        std::vector<std::pair<std::string_view, size_t>> valueEntries;
+        std::unordered_set<std::string_view> seen;
+        for (size_t r : accepted) {
+            if (rules[r].substring) state.substrings.push_back(r);
+            else if (seen.insert(rules[r].from).second) valueEntries.emplace_back(rules[r].from, r);
+        }
+        state.values.build(valueEntries);
+        states[s] = std::move(state);
+    }
+}
+
+int JsonRewriter::keyTransition(int state, std::string_view key) const {
+    const PathState& st = states[state];
+    size_t next;
+    return st.keyNext.find(key, next) ? static_cast<int>(next) : st.otherKeyNext;
+}
+
+int JsonRewriter::indexTransition(int state, size_t index) const {
+    const PathState& st = states[state];
+    auto it = st.indexNext.find(index);
+    return it == st.indexNext.end() ? st.otherIndexNext : it->second;
+}
+
+size_t JsonRewriter::rewriteString(std::string_view text, const std::vector<size_t>& substrings,
+                                   std::string& output) const {
+    size_t replaced = 0;
+    size_t pos = 0;
+    while (true) {
+        // Earliest occurrence of any rule from pos on
+        size_t best = std::string_view::npos;
+        const Rule* rule = nullptr;
+        for (size_t r : substrings) {
+            size_t at = text.find(rules[r].from, pos);
+            if (at < best) {
+                best = at;
+                rule = &rules[r];
+            }
+        }
+        if (rule == nullptr) break;
+        output.append(text.data() + pos, best - pos);
+        output += rule->to;
+        pos = best + rule->from.size();
+        replaced++;
+    }
+    output.append(text.data() + pos, text.size() - pos);
+    return replaced;
+}
+
+size_t JsonRewriter::rewrite(std::string_view input, std::string& output) const {
+    if (states.empty()) throw std::logic_error("JsonRewriter::compile() was not called");
+
+    // One frame per open object or array
+    struct Frame {
+        int state;          // automaton state of the container itself
+        bool object;
+        bool expectKey;     // object: the next string is a key
+        int valueState;     // object: state of the member being read
+        size_t index;       // array: index of the element being read
+    };
+    std::vector<Frame> frames;
+
+    // State of the value that starts next
+    auto valueState = [&]() {
+        if (frames.empty()) return start;
+        const Frame& f = frames.back();
+        return f.object ? f.valueState : indexTransition(f.state, f.index);
+    };
+
+    size_t replaced = 0;
+    const char* p = input.data();
+    const char* end = p + input.size();
+    const char* copyFrom = p; // start of the bytes not yet copied to output
+
+    while (p < end) {
+        char c = *p;
+        switch (c) {
+        case '{':
+        case '[': {
+            int state = valueState();
+            if (!states[state].live) { // nothing below can match
+                p = skipContainer(p, end);
+                continue;
+            }
+            frames.push_back(Frame{state, c == '{', c == '{', DEAD, 0});
+            ++p;
+            continue;
+        }
+        case '}':
+        case ']':
+            if (!frames.empty()) frames.pop_back();
+            ++p;
+            continue;
+        case ',':
+            if (!frames.empty()) {
+                Frame& f = frames.back();
+                if (f.object) f.expectKey = true;
+                else f.index++;
+            }
+            ++p;
+            continue;
+        case ':':
+            if (!frames.empty()) frames.back().expectKey = false;
+            ++p;
+            continue;
+        case '"':
+            break;
+        default: // whitespace, numbers, true/false/null
+            ++p;
+            continue;
+        }
+
+        // Find the closing quote; a quote preceded by an odd number of
+        // backslashes is escaped
+        const char* textBegin = p + 1;
+        const char* close = textBegin;
+        while (true) {
+            close = static_cast<const char*>(std::memchr(close, '"', end - close));
+            if (close == nullptr) { // unterminated string
+                if (replaced > 0) output.append(copyFrom, end);
+                return replaced;
+            }
+            const char* slashes = close;
+            while (slashes > textBegin && slashes[-1] == '\\') --slashes;
+            if ((close - slashes) % 2 == 0) break;
+            ++close;
+        }
+        std::string_view text(textBegin, close - textBegin);
+        const char* next = close + 1;
+
+        if (!frames.empty() && frames.back().object && frames.back().expectKey) {
+            Frame& f = frames.back();
+            f.valueState = keyTransition(f.state, text);
+            p = next;
+            continue;
+        }
+
+        const PathState& st = states[valueState()];
+        if (!st.values.empty()) {
+            size_t rule;
+            if (st.values.find(text, rule)) {
+                output.append(copyFrom, p);
+                output += rules[rule].to;
+                copyFrom = next;
+                p = next;
+                replaced++;
+                continue;
+            }
+        }
+        for (size_t r : st.substrings) {
+            if (text.find(rules[r].from) != std::string_view::npos) {
+                output.append(copyFrom, textBegin);
+                replaced += rewriteString(text, st.substrings, output);
+                copyFrom = close;
+                break;
+            }
+        }
+        p = next;
+    }
+    // Bytes are only copied once the first replacement is found, so an input
+    // with no hits leaves output untouched
+    if (replaced > 0) output.append(copyFrom, end);
+    return replaced;
+}
@@ -0,0 +1,104 @@
+#ifndef JSON_REWRITER_H
+#define JSON_REWRITER_H
+
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "perfect_hash.h"
+
+// Rewrites a JSON document in a single pass with rules scoped to JSON paths.
+//
+// Paths are a JSONPath subset: "$" followed by steps
+//   .name   member of an object        [N]  element N of an array
+//   .*      any member or element      [*]  same as .*
+//   ..step  the step at any depth below
+// e.g. "$.status", "$.permissions[*]", "$.preferences.notifications", "$..*".
+//
+// All rule paths are compiled into one deterministic automaton over path
+// steps. While the document is parsed, every open object or array carries
+// its automaton state, so finding the rules for a value is one transition
+// per key or index. Key transitions and value rules are perfect-hash
+// tables, so a string token costs one probe whatever the number of rules.
+// Subtrees no path can reach are skipped without tokenizing, and every byte
+// that no rule touches is copied through unchanged.
+class JsonRewriter {
+public:
+    JsonRewriter() = default;
+    // The automaton points into the rules themselves
+    JsonRewriter(const JsonRewriter&) = delete;
+    JsonRewriter& operator=(const JsonRewriter&) = delete;
+
+    // A string value at path whose text equals value is replaced by
+    // replacementJson (any JSON text, e.g. an object). When several rules
+    // match, the first one added wins.
+    // Throws std::invalid_argument for a malformed path.
+    void addValueRule(const std::string& path, const std::string& value, const std::string& replacementJson);
+
+    // Every occurrence of from inside a string value at path becomes to
+    void addSubstringRule(const std::string& path, const std::string& from, const std::string& to);
+
+    // Builds the automaton; call after the last add and before rewrite()
+    void compile();
+
+    // Appends the rewritten document to output and returns the number of
+    // replacements made. Malformed input is copied through from the point
+    // where it stops being JSON. When nothing is replaced output is left
+    // untouched, since the document is then input itself.
+    size_t rewrite(std::string_view input, std::string& output) const;
+
+private:
+    struct Step {
+        enum Kind { KEY, INDEX, ANY } kind;
+        std::string name;     // KEY
+        size_t index = 0;     // INDEX
+        bool descendant = false; // ".." before the step
+    };
+
+    struct Rule {
+        std::string from;
+        std::string to;
+        bool substring; // replace occurrences of from instead of the whole value
+    };
+
+    // One distinct path and the rules attached to it
+    struct Pattern {
+        std::string path;
+        std::vector<Step> steps;
+        std::vector<size_t> rules; // indices into rules, in the order added
+    };
+
+    // A state of the path automaton
+    struct PathState {
+        PerfectHashTable keyNext; // keys named in some path -> next state
+        int otherKeyNext = 0;
+        std::unordered_map<size_t, int> indexNext;         // indices named in some path
+        int otherIndexNext = 0;
+        bool live = false; // some path can still match here or below
+        // Rules for a string value in this state: value text -> rule index
+        PerfectHashTable values;
+        std::vector<size_t> substrings;
+    };
+
+    static const int DEAD = 0; // state no path can leave
+
+    std::deque<Rule> rules; // a deque never moves its elements
+    std::deque<std::string> keyNames;
+    std::vector<Pattern> patterns;
+    std::vector<PathState> states;
+    int start = DEAD; // state of the document root
+
+    static std::vector<Step> parsePath(const std::string& path);
+    Pattern& patternFor(const std::string& path);
+    void addRule(const std::string& path, Rule rule);
+
+    int keyTransition(int state, std::string_view key) const;
+    int indexTransition(int state, size_t index) const;
+
+    // Copies the text of one string value, applying substring rules
+    size_t rewriteString(std::string_view text, const std::vector<size_t>& substrings, std::string& output) const;
+};
+
+#endif // JSON_REWRITER_H
@@ -1,16 +1,19 @@
 #include <iostream>
 #include <string>
 #include <filesystem>
+#include <algorithm>
+#include <cstdlib>
 #include "json_processor.h"
 #include "file_utils.h"
 
 namespace fs = std::filesystem;
 
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        std::cerr << "Usage: " << argv[0] << " <path_to_user_profiles_directory>" << std::endl;
+    if (argc != 2 && !(argc == 4 && std::string(argv[2]) == "--threads")) {
+        std::cerr << "Usage: " << argv[0] << " <path_to_user_profiles_directory> [--threads N]" << std::endl;
         return 1;
     }
+    unsigned threadCount = argc == 4 ? static_cast<unsigned>(std::max(1, std::atoi(argv[3]))) : 0;
 
     std::string inputPath = argv[1];
     
@@ -25,7 +28,7 @@ int main(int argc, char* argv[]) {
         std::cout << "Output directory: " << outputDir << std::endl;
 
         // Process all JSON files
-        JsonProcessor processor;
+        JsonProcessor processor(threadCount);
         size_t processedFiles = processor.processDirectory(inputPath, outputDir);
         
         std::cout << "Successfully processed " << processedFiles << " files." << std::endl;
@@ -0,0 +1,47 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#include <fstream>
+#include <sstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const fs::path& path) {
+#ifdef _WIN32
+    std::ifstream input(path, std::ios::binary);
+    if (!input.is_open()) return;
+    std::ostringstream buffer;
+    buffer << input.rdbuf();
+    contents = buffer.str();
+    data = contents.data();
+    size = contents.size();
+    open = true;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    struct stat info;
+    if (::fstat(fd, &info) == 0) {
+        size = static_cast<size_t>(info.st_size);
+        if (size == 0) {
+            open = true; // nothing to map
+        } else {
+            void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED) {
+                data = static_cast<const char*>(mapping);
+                open = true;
+            }
+        }
+    }
+    ::close(fd); // the mapping stays valid
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifndef _WIN32
+    if (data != nullptr) ::munmap(const_cast<char*>(data), size);
+#endif
+}
@@ -0,0 +1,32 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace fs = std::filesystem;
+
+// Read-only view of a whole file. On POSIX systems the file is mapped, so
+// reading it copies nothing into the process; elsewhere it is read into
+// memory once.
+class MappedFile {
+public:
+    explicit MappedFile(const fs::path& path);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isOpen() const { return open; }
+    std::string_view view() const { return std::string_view(data, size); }
+
+private:
+    const char* data = nullptr;
+    size_t size = 0;
+    bool open = false;
+#ifdef _WIN32
+    std::string contents;
+#endif
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,113 @@
+#include "perfect_hash.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace {
+uint64_t mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// Displacements tried per bucket before starting over with a new seed
+const uint32_t MAX_DISPLACEMENT = 1u << 16;
+}
+
+// Eight bytes per step; the tail is read with memcpy so short keys never
+// read past their end
+uint64_t PerfectHashTable::hash(std::string_view key, uint64_t seed) {
+    uint64_t h = seed ^ (key.size() * 0x9E3779B97F4A7C15ULL);
+    size_t i = 0;
+    for (; i + 8 <= key.size(); i += 8) {
+        uint64_t word;
+        std::memcpy(&word, key.data() + i, 8);
+        h = (h ^ word) * 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 32;
+    }
+    uint64_t tail = 0;
+    if (i < key.size()) std::memcpy(&tail, key.data() + i, key.size() - i);
+    return mix(h ^ tail);
+}
+
+size_t PerfectHashTable::slotFor(uint64_t h, uint32_t displacement) const {
+    return static_cast<size_t>(mix(h + displacement * 0x9E3779B97F4A7C15ULL) % slots.size());
+}
+
+void PerfectHashTable::build(const std::vector<std::pair<std::string_view, size_t>>& entries) {
+    slots.clear();
+    displacements.clear();
+    if (entries.empty()) return;
+
+    std::vector<std::string_view> keys;
+    for (const auto& entry : entries) keys.push_back(entry.first);
+    std::sort(keys.begin(), keys.end());
+    auto dup = std::adjacent_find(keys.begin(), keys.end());
+    if (dup != keys.end()) throw std::invalid_argument("Duplicate key in perfect hash table: " + std::string(*dup));
+    for (const auto& entry : entries)
+        if (entry.second >= EMPTY) throw std::invalid_argument("Perfect hash table value out of range");
+
+    shortest = keys.front().size();
+    longest = 0;
+    for (auto key : keys) {
+        shortest = std::min(shortest, key.size());
+        longest = std::max(longest, key.size());
+    }
+
+    // A seed fails only when two keys share a full hash or a bucket runs
+    // out of displacements; both are rare, so few retries are ever needed
+    for (seed = 0;; ++seed) {
+        if (tryBuild(entries)) return;
+    }
+}
+
+bool PerfectHashTable::tryBuild(const std::vector<std::pair<std::string_view, size_t>>& entries) {
+    // About four keys per bucket, and a fifth more slots than keys
+    size_t n = entries.size();
+    displacements.assign(n / 4 + 1, 0);
+    slots.assign(n + n / 5 + 1, Slot{});
+
+    std::vector<std::vector<size_t>> buckets(displacements.size());
+    std::vector<uint64_t> hashes(n);
+    for (size_t i = 0; i < n; ++i) {
+        hashes[i] = hash(entries[i].first, seed);
+        buckets[bucketFor(hashes[i])].push_back(i);
+    }
+
+    // Largest buckets first, while most slots are still free
+    std::vector<size_t> order(buckets.size());
+    for (size_t b = 0; b < order.size(); ++b) order[b] = b;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return buckets[a].size() > buckets[b].size(); });
+
+    std::vector<size_t> chosen;
+    for (size_t b : order) {
+        if (buckets[b].empty()) break;
+        bool placed = false;
+        for (uint32_t d = 0; d < MAX_DISPLACEMENT && !placed; ++d) {
+            chosen.clear();
+            placed = true;
+            for (size_t i : buckets[b]) {
+                size_t slot = slotFor(hashes[i], d);
+                if (slots[slot].value != EMPTY || std::find(chosen.begin(), chosen.end(), slot) != chosen.end()) {
+                    placed = false;
+                    break;
+                }
+                chosen.push_back(slot);
+            }
+            if (placed) {
+                displacements[b] = d;
+                for (size_t k = 0; k < chosen.size(); ++k) {
+                    const auto& entry = entries[buckets[b][k]];
+                    uint64_t h = hashes[buckets[b][k]];
+                    slots[chosen[k]] = Slot{entry.first, static_cast<uint32_t>(h), static_cast<uint32_t>(entry.second)};
+                }
+            }
+        }
+        if (!placed) return false;
+    }
+    return true;
+}
@@ -0,0 +1,56 @@
+#ifndef PERFECT_HASH_H
+#define PERFECT_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Immutable string -> index table with no collisions ("hash and displace").
+// Keys are hashed once; the hash picks a bucket, and the bucket's
+// displacement, chosen at build time so that no two keys share a slot,
+// turns the same hash into the key's slot. A lookup is therefore one hash
+// of the token, one slot and one comparison, however many keys there are.
+// Slots keep part of the hash, so most absent keys are rejected without
+// touching the key's bytes. The keys are views; their storage must outlive
+// the table.
+class PerfectHashTable {
+public:
+    // Throws std::invalid_argument on duplicate keys or an index of 2^32 - 1 or more
+    void build(const std::vector<std::pair<std::string_view, size_t>>& entries);
+
+    // Sets value to the index stored for key; false if key is absent
+    bool find(std::string_view key, size_t& value) const {
+        if (slots.empty() || key.size() < shortest || key.size() > longest) return false;
+        uint64_t h = hash(key, seed);
+        const Slot& slot = slots[slotFor(h, displacements[bucketFor(h)])];
+        if (slot.value == EMPTY || slot.fingerprint != static_cast<uint32_t>(h) || slot.key != key) return false;
+        value = slot.value;
+        return true;
+    }
+
+    bool empty() const { return slots.empty(); }
+
+private:
+    static const uint32_t EMPTY = 0xFFFFFFFF;
+
+    struct Slot {
+        std::string_view key;
+        uint32_t fingerprint = 0; // low half of the key's hash
+        uint32_t value = EMPTY;
+    };
+
+    std::vector<Slot> slots;
+    std::vector<uint32_t> displacements; // per bucket
+    uint64_t seed = 0;
+    size_t shortest = 0;
+    size_t longest = 0;
+
+    static uint64_t hash(std::string_view key, uint64_t seed);
+    size_t bucketFor(uint64_t h) const { return static_cast<size_t>((h >> 32) % displacements.size()); }
+    size_t slotFor(uint64_t h, uint32_t displacement) const;
+    bool tryBuild(const std::vector<std::pair<std::string_view, size_t>>& entries);
+};
+
+#endif // PERFECT_HASH_H
@@ -0,0 +1,74 @@
+#ifndef WORK_QUEUE_H
+#define WORK_QUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+// Bounded multi-producer/multi-consumer queue connecting the pipeline stages.
+// push() blocks while the queue is full, so a fast stage cannot run ahead
+// of a slow one and hold millions of items in memory.
+template <typename T>
+class WorkQueue {
+public:
+    explicit WorkQueue(size_t capacity) : capacity(capacity) {}
+
+    // Returns false if the queue was closed
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [this] { return closed || items.size() < capacity; });
+        if (closed) return false;
+        items.push_back(std::move(item));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    // Blocks until an item is available; returns false once the queue is
+    // closed and drained
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [this] { return closed || !items.empty(); });
+        if (items.empty()) return false;
+        item = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    // Non-blocking variants: false instead of waiting when full or empty
+    bool tryPush(T item) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (closed || items.size() >= capacity) return false;
+        items.push_back(std::move(item));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    bool tryPop(T& item) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (items.empty()) return false;
+        item = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    // No more pushes; consumers finish what is queued
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+
+private:
+    size_t capacity;
+    std::deque<T> items;
+    bool closed = false;
+    std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+};
+
+#endif // WORK_QUEUE_H